@@ -0,0 +1,253 @@
+#include "fen/Fen.hpp"
+#include "notation/Notation.hpp"
+#include "search/Search.hpp"
+#include "tablebase/Tablebases.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// analyzes every position of an EPD or FEN file with the engine, one search per worker thread.
+// the results are printed tab separated in the order the searches finish, the line number links them to the input
+
+namespace {
+    struct Job {
+        size_t line_number;
+        std::string line;
+    };
+
+    // lines waiting for a worker, bounded so a large file is not read into memory at once
+    class JobQueue {
+        std::deque<Job> jobs;
+        size_t capacity;
+        bool closed{false};
+        std::mutex mutex;
+        std::condition_variable not_empty;
+        std::condition_variable not_full;
+    public:
+        explicit JobQueue(size_t capacity) : capacity(capacity) {}
+
+        void push(Job job) {
+            std::unique_lock lock(mutex);
+            not_full.wait(lock, [this]() { return jobs.size() < capacity; });
+            jobs.push_back(std::move(job));
+            not_empty.notify_one();
+        }
+
+        /**
+         * Waits for the next job.
+         * @return The job, nothing if the queue is closed and empty.
+         */
+        std::optional<Job> pop() {
+            std::unique_lock lock(mutex);
+            not_empty.wait(lock, [this]() { return !jobs.empty() || closed; });
+
+            if (jobs.empty()) {
+                return std::nullopt;
+            }
+
+            auto job = std::move(jobs.front());
+            jobs.pop_front();
+            not_full.notify_one();
+            return job;
+        }
+
+        void close() {
+            std::lock_guard lock(mutex);
+            closed = true;
+            not_empty.notify_all();
+        }
+    };
+
+    struct Options {
+        std::string input{"-"};
+        SearchLimits limits;
+        unsigned int threads{1};
+        size_t hash_mb{16};
+    };
+
+    std::string score_to_string(int score) {
+        if (score >= MATE_BOUND) {
+            return "mate " + std::to_string((MATE_SCORE - score + 1) / 2);
+        }
+        if (score <= -MATE_BOUND) {
+            return "mate -" + std::to_string((MATE_SCORE + score) / 2);
+        }
+        return "cp " + std::to_string(score);
+    }
+
+    /**
+     * @return The moves of the line in the uci notation, separated by spaces.
+     */
+    std::string line_to_string(const GameBoard& board, const PvLine& line) {
+        std::string text;
+        auto position = GameBoard{board};
+
+        for (const auto& move : line.moves) {
+            if (!text.empty()) {
+                text += ' ';
+            }
+            text += Notation::to_uci(position, move).view();
+            position.make_move(move);
+            position.flip();
+        }
+
+        return text;
+    }
+
+    /**
+     * Searches the positions of the queue until it is closed.
+     */
+    void work(JobQueue& queue, const Options& options, std::mutex& output_mutex) {
+        Search search{SearchOptions{}, options.hash_mb};
+
+        while (auto job = queue.pop()) {
+            Color side_to_move;
+            std::optional<GameBoard> board;
+
+            try {
+                board.emplace(Fen::parse(job->line, side_to_move));
+            } catch (const std::invalid_argument& e) {
+                std::lock_guard lock(output_mutex);
+                std::cerr << "line " << job->line_number << ": " << e.what() << std::endl;
+                continue;
+            }
+
+            // the positions have nothing to do with each other
+            search.clear();
+
+            auto start = std::chrono::steady_clock::now();
+            auto result = search.think(*board, side_to_move, options.limits);
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+            auto best_move = result.best_move.is_valid() ? Notation::to_uci(*board, result.best_move) : MoveText{};
+            auto id = Fen::epd_operation(job->line, "id");
+
+            std::lock_guard lock(output_mutex);
+            if (options.limits.multi_pv == 1) {
+                std::cout << job->line_number << '\t' << id << '\t'
+                          << (best_move.empty() ? "none" : best_move.view()) << '\t'
+                          << score_to_string(result.score) << '\t' << result.depth << '\t' << result.nodes << '\t'
+                          << elapsed.count() << std::endl;
+                continue;
+            }
+
+            // a position without legal moves has no lines, it still gets a row of its own
+            if (result.lines.empty()) {
+                std::cout << job->line_number << '\t' << id << '\t' << "none" << '\t'
+                          << score_to_string(result.score) << '\t' << result.depth << '\t' << result.nodes << '\t'
+                          << elapsed.count() << '\t' << 1 << '\t' << std::endl;
+                continue;
+            }
+
+            // one row for every line, the first move of the line takes the place of the best move
+            for (size_t i = 0; i < result.lines.size(); ++i) {
+                const auto& line = result.lines[i];
+                auto first_move = line.moves.empty() ? MoveText{} : Notation::to_uci(*board, line.moves[0]);
+                std::cout << job->line_number << '\t' << id << '\t' << (first_move.empty() ? "none" : first_move.view()) << '\t'
+                          << score_to_string(line.score) << '\t' << line.depth << '\t' << result.nodes << '\t'
+                          << elapsed.count() << '\t' << i + 1 << '\t' << line_to_string(*board, line) << std::endl;
+            }
+        }
+    }
+
+    void print_usage() {
+        std::cout << "Usage: analyze [file|-] [--depth=n] [--nodes=n] [--time=ms] [--threads=n] [--hash=mb]" << std::endl;
+        std::cout << "               [--multipv=n]" << std::endl;
+        std::cout << "Searches every FEN or EPD line of the file (or standard input) and prints the best move." << std::endl;
+        std::cout << "With --multipv the best n moves are printed, each with its rank and its expected line." << std::endl;
+        std::cout << "Without limits every position is searched to depth 8." << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    options.limits.depth = 0;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string argument = argv[i];
+            auto value = argument.substr(argument.find('=') + 1);
+
+            if (argument.rfind("--depth=", 0) == 0) {
+                options.limits.depth = std::stoi(value);
+            } else if (argument.rfind("--nodes=", 0) == 0) {
+                options.limits.nodes = std::stoull(value);
+            } else if (argument.rfind("--time=", 0) == 0) {
+                options.limits.time_ms = std::stoll(value);
+            } else if (argument.rfind("--threads=", 0) == 0) {
+                options.threads = static_cast<unsigned int>(std::max(1, std::stoi(value)));
+            } else if (argument.rfind("--hash=", 0) == 0) {
+                options.hash_mb = std::stoul(value);
+            } else if (argument.rfind("--multipv=", 0) == 0) {
+                options.limits.multi_pv = std::max(1, std::stoi(value));
+            } else if (argument.rfind("--", 0) != 0) {
+                options.input = argument;
+            } else {
+                print_usage();
+                return argument == "--help" ? 0 : 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    if (options.limits.depth <= 0) {
+        auto unlimited = options.limits.nodes == 0 && options.limits.time_ms == 0;
+        options.limits.depth = unlimited ? 8 : MAX_PLY - 1;
+    }
+
+    // the directories of the syzygy tablebase files, separated by ':'
+    if (auto syzygy_path = std::getenv("SYZYGY_PATH")) {
+        Tablebases::init(syzygy_path);
+    }
+
+    std::ifstream file;
+    if (options.input != "-") {
+        file.open(options.input);
+        if (!file) {
+            std::cerr << "Could not open " << options.input << std::endl;
+            return 1;
+        }
+    }
+    auto& input = (options.input == "-") ? std::cin : file;
+
+    std::cout << "line\tid\tbestmove\tscore\tdepth\tnodes\ttime_ms"
+              << (options.limits.multi_pv > 1 ? "\tmultipv\tpv" : "") << std::endl;
+
+    JobQueue queue{options.threads * 4};
+    std::mutex output_mutex;
+    std::vector<std::thread> workers;
+
+    for (unsigned int i = 0; i < options.threads; ++i) {
+        workers.emplace_back(work, std::ref(queue), std::cref(options), std::ref(output_mutex));
+    }
+
+    std::string line;
+    size_t line_number = 0;
+
+    while (std::getline(input, line)) {
+        ++line_number;
+        if (line.find_first_not_of(" \t\r") == std::string::npos || line[0] == '#') {
+            continue;
+        }
+        queue.push({line_number, line});
+    }
+
+    queue.close();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    return 0;
+}
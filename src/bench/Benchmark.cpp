@@ -0,0 +1,117 @@
+#include "Benchmark.hpp"
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+#include <thread>
+
+// *****************************************************
+// Public Methods
+// *****************************************************
+
+void BenchmarkRunner::add(const std::string& name, std::function<uint64_t()> batch) {
+    if (filter.empty() || name.find(filter) != std::string::npos) {
+        cases.push_back({name, std::move(batch)});
+    }
+}
+
+/**
+ * Runs all benchmarks, each one after a warm up batch until the minimum time is reached.
+ * @param progress The name of every benchmark is written here before it runs.
+ * @return The results in the order the benchmarks were added.
+ */
+std::vector<BenchmarkResult> BenchmarkRunner::run(std::ostream& progress) const {
+    std::vector<BenchmarkResult> results;
+
+    for (const auto& benchmark : cases) {
+        progress << "running " << benchmark.name << std::endl;
+
+        // the warm up fills the caches and the branch predictors
+        do_not_optimize(benchmark.batch());
+
+        uint64_t operations = 0;
+        uint64_t iterations = 0;
+        auto start = std::chrono::steady_clock::now();
+        double elapsed = 0;
+
+        while (elapsed < min_time_s) {
+            operations += benchmark.batch();
+            ++iterations;
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        BenchmarkResult result;
+        result.name = benchmark.name;
+        result.iterations = iterations;
+        result.operations = operations;
+        result.ns_per_op = operations ? elapsed * 1e9 / static_cast<double>(operations) : 0;
+        result.ops_per_second = static_cast<double>(operations) / elapsed;
+        results.push_back(result);
+    }
+
+    return results;
+}
+
+/**
+ * Writes the results as a table, as json (in the format of google benchmark) or as csv.
+ */
+void BenchmarkRunner::report(const std::vector<BenchmarkResult>& results, OutputFormat format, std::ostream& out) {
+    switch (format) {
+        case OutputFormat::JSON: {
+            auto now = std::time(nullptr);
+            char date[32];
+            std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+            out << "{\n";
+            out << "  \"context\": {\n";
+            out << "    \"date\": \"" << date << "\",\n";
+            out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << "\n";
+            out << "  },\n";
+            out << "  \"benchmarks\": [\n";
+
+            for (size_t i = 0; i < results.size(); ++i) {
+                const auto& result = results[i];
+                out << "    {\n";
+                out << "      \"name\": \"" << result.name << "\",\n";
+                out << "      \"iterations\": " << result.iterations << ",\n";
+                out << "      \"operations\": " << result.operations << ",\n";
+                out << "      \"real_time\": " << std::fixed << std::setprecision(2) << result.ns_per_op << ",\n";
+                out << "      \"time_unit\": \"ns\",\n";
+                out << "      \"items_per_second\": " << std::setprecision(0) << result.ops_per_second << "\n";
+                out << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+            }
+
+            out << "  ]\n";
+            out << "}" << std::endl;
+            break;
+        }
+        case OutputFormat::CSV:
+            out << "name,iterations,operations,real_time,time_unit,items_per_second\n";
+            for (const auto& result : results) {
+                out << result.name << ","
+                    << result.iterations << ","
+                    << result.operations << ","
+                    << std::fixed << std::setprecision(2) << result.ns_per_op << ",ns,"
+                    << std::setprecision(0) << result.ops_per_second << "\n";
+            }
+            out.flush();
+            break;
+        case OutputFormat::CONSOLE:
+        default:
+            out << std::left << std::setw(44) << "Benchmark"
+                << std::right << std::setw(16) << "Time"
+                << std::setw(14) << "Iterations"
+                << std::setw(14) << "Operations"
+                << std::setw(16) << "Items/s" << "\n";
+            out << std::string(104, '-') << "\n";
+
+            for (const auto& result : results) {
+                out << std::left << std::setw(44) << result.name
+                    << std::right << std::setw(13) << std::fixed << std::setprecision(1) << result.ns_per_op << " ns"
+                    << std::setw(14) << result.iterations
+                    << std::setw(14) << result.operations
+                    << std::setw(16) << std::setprecision(0) << result.ops_per_second << "\n";
+            }
+            out.flush();
+            break;
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// keeps the compiler from removing a computation whose result is not used
+template<typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
+
+enum class OutputFormat {
+    CONSOLE,
+    JSON,
+    CSV
+};
+
+// a benchmark runs a batch of operations and returns how many operations it did,
+// the batch is repeated until the minimum time is reached
+struct BenchmarkCase {
+    std::string name;
+    std::function<uint64_t()> batch;
+};
+
+// the times are per operation, a batch can do many operations, like one per position or per move
+struct BenchmarkResult {
+    std::string name;
+    uint64_t iterations{0}; // how often the batch ran
+    uint64_t operations{0}; // the operations of all these batches
+    double ns_per_op{0};
+    double ops_per_second{0};
+};
+
+// minimal runner in the style of google benchmark, without any dependencies
+class BenchmarkRunner {
+    std::vector<BenchmarkCase> cases;
+    double min_time_s;
+    std::string filter;
+
+public:
+    BenchmarkRunner(double min_time_s, std::string filter) : min_time_s(min_time_s), filter(std::move(filter)) {}
+
+    void add(const std::string& name, std::function<uint64_t()> batch);
+    [[nodiscard]] std::vector<BenchmarkResult> run(std::ostream& progress) const;
+
+    static void report(const std::vector<BenchmarkResult>& results, OutputFormat format, std::ostream& out);
+};
@@ -0,0 +1,278 @@
+#include "Benchmark.hpp"
+#include "gameboard/GameBoard.hpp"
+#include "position/PositionHistory.hpp"
+#include "hash/Zobrist.hpp"
+#include "movegen/MoveGen.hpp"
+#include "notation/Notation.hpp"
+#include "random/Random.hpp"
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// micro benchmarks of the gameboard functions used by the game loop,
+// run over a fixed set of positions so the numbers are comparable between versions
+
+namespace {
+    struct BenchPosition {
+        std::string name;
+        GameBoard board;
+        Color side_to_move;
+    };
+
+    /**
+     * Plays a move given in the uci notation like e2e4 or e7e8q.
+     */
+    void play(BenchPosition& position, std::string_view move) {
+        auto& board = position.board;
+        board.make_move(Notation::from_uci(board, position.side_to_move, move));
+        board.flip();
+        position.side_to_move = enemy_of(position.side_to_move);
+    }
+
+    std::vector<BenchPosition> create_positions() {
+        std::vector<BenchPosition> positions;
+
+        positions.push_back({"start", GameBoard{GameTest::NORMAL}, Color::WHITE});
+
+        BenchPosition italian{"italian", GameBoard{GameTest::NORMAL}, Color::WHITE};
+        for (const auto& move : {"e2e4", "e7e5", "g1f3", "b8c6", "f1c4", "f8c5", "c2c3", "g8f6", "d2d3", "d7d6", "e1g1", "e8g8", "b1d2"}) {
+            play(italian, move);
+        }
+        positions.push_back(italian);
+
+        positions.push_back({"check", GameBoard{GameTest::CHECK}, Color::WHITE});
+        positions.push_back({"checkmate", GameBoard{GameTest::CHECKMATE}, Color::WHITE});
+        positions.push_back({"promotion", GameBoard{GameTest::PROMOTION}, Color::WHITE});
+        positions.push_back({"en_passant", GameBoard{GameTest::EN_PASSANT}, Color::WHITE});
+        positions.push_back({"castling", GameBoard{GameTest::CASTLING}, Color::WHITE});
+
+        return positions;
+    }
+
+    /**
+     * Collects the fields of the pieces of the player to move, optionally only of one piece type.
+     */
+    VecPos pieces_of(const GameBoard& board, Color color, char name = ' ') {
+        VecPos result;
+        for (int x = 0; x < 8; ++x) {
+            for (int y = 0; y < 8; ++y) {
+                auto piece = board.get_piece({x, y});
+                if (piece && piece->get_color() == color && (name == ' ' || piece->get_name() == name)) {
+                    result.emplace_back(x, y);
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Plays a game with random moves through the same functions as the game loop of the console game,
+     * the legal moves come from the move generator like the moves of the search.
+     * @return The number of half moves played.
+     */
+    uint64_t play_random_game(uint64_t seed) {
+        Random random{seed};
+
+        GameBoard board{GameTest::NORMAL};
+        PositionHistory history;
+        auto current_player = Color::WHITE;
+        uint64_t plies = 0;
+
+        while (plies < 400) {
+            MoveList legal_moves;
+            MoveGen::generate_legal(board, current_player, legal_moves);
+
+            if (legal_moves.empty()) {
+                break;
+            }
+
+            auto move = legal_moves[static_cast<int>(random.below(static_cast<uint64_t>(legal_moves.size())))];
+
+            // the game loop checks the move of the ai with the gameboard
+            auto valid_moves = board.get_valid_moves_for(move.get_from());
+            if (!move.get_to().exists_in(valid_moves)) {
+                break;
+            }
+
+            history.push(Zobrist::hash(board, current_player));
+            board.make_move(move);
+            ++plies;
+
+            if (board.is_game_over(current_player) || board.is_stalemate(current_player)) {
+                break;
+            }
+
+            current_player = enemy_of(current_player);
+            board.flip();
+
+            if (board.is_draw(history, current_player)) {
+                break;
+            }
+        }
+
+        return plies;
+    }
+
+    void add_benchmarks(BenchmarkRunner& runner, std::vector<BenchPosition>& positions) {
+        for (auto& position : positions) {
+            runner.add("GameBoard_copy/" + position.name, [&position]() {
+                auto copy = GameBoard{position.board};
+                do_not_optimize(copy);
+                return uint64_t{1};
+            });
+        }
+
+        for (auto& position : positions) {
+            runner.add("flip/" + position.name, [&position]() {
+                position.board.flip();
+                position.board.flip();
+                return uint64_t{2};
+            });
+        }
+
+        // every piece of the type in every position
+        for (auto name : {'P', 'N', 'B', 'R', 'Q', 'K'}) {
+            runner.add(std::string("get_valid_moves_for/") + name, [&positions, name]() {
+                uint64_t calls = 0;
+                for (auto& position : positions) {
+                    for (const auto& piece : pieces_of(position.board, position.side_to_move, name)) {
+                        auto moves = position.board.get_valid_moves_for(piece);
+                        do_not_optimize(moves);
+                        ++calls;
+                    }
+                }
+                return calls;
+            });
+        }
+
+        // the moves are already legal, so validate_moves does the same work but removes nothing
+        for (auto name : {'P', 'N', 'B', 'R', 'Q', 'K'}) {
+            std::vector<std::pair<const BenchPosition*, std::pair<Position, VecPos>>> inputs;
+            for (auto& position : positions) {
+                for (const auto& piece : pieces_of(position.board, position.side_to_move, name)) {
+                    inputs.push_back({&position, {piece, position.board.get_valid_moves_for(piece)}});
+                }
+            }
+
+            runner.add(std::string("validate_moves/") + name, [inputs]() {
+                for (const auto& [position, input] : inputs) {
+                    auto moves = input.second;
+                    position->board.validate_moves(input.first, position->board.get_piece(input.first), moves);
+                    do_not_optimize(moves);
+                }
+                return static_cast<uint64_t>(inputs.size());
+            });
+        }
+
+        // the gameboard keeps the answer until the next move, so every call gets a new copy without it,
+        // this includes the time of GameBoard_copy
+        for (auto& position : positions) {
+            runner.add("is_king_in_check/" + position.name, [&position]() {
+                auto copy = GameBoard{position.board};
+                do_not_optimize(copy.is_king_in_check(position.side_to_move));
+                return uint64_t{1};
+            });
+        }
+
+        // the board has to be copied for every move, so this includes the time of GameBoard_copy
+        for (auto& position : positions) {
+            VecPos from;
+            std::vector<Position> to;
+            for (const auto& piece : pieces_of(position.board, position.side_to_move)) {
+                for (const auto& move : position.board.get_valid_moves_for(piece)) {
+                    from.push_back(piece);
+                    to.push_back(move);
+                }
+            }
+
+            if (from.empty()) {
+                continue;
+            }
+
+            runner.add("move_piece/" + position.name, [&position, from, to]() {
+                for (size_t i = 0; i < from.size(); ++i) {
+                    auto copy = GameBoard{position.board};
+                    copy.move_piece(from[i], to[i], false);
+                    do_not_optimize(copy);
+                }
+                return static_cast<uint64_t>(from.size());
+            });
+        }
+
+        // the same call as is_game_over, the moves of the opponent are checked. like is_king_in_check on a new copy
+        for (auto& position : positions) {
+            runner.add("has_moves_left/" + position.name, [&position]() {
+                auto copy = GameBoard{position.board};
+                do_not_optimize(copy.has_moves_left(enemy_of(position.side_to_move)));
+                return uint64_t{1};
+            });
+        }
+
+        // every batch plays the same games, so the numbers do not depend on the luck of the moves
+        runner.add("full_game/random/games", []() {
+            do_not_optimize(play_random_game(1));
+            return uint64_t{1};
+        });
+
+        runner.add("full_game/random/plies", []() {
+            return play_random_game(1);
+        });
+    }
+
+    void print_usage() {
+        std::cout << "Usage: bench [--format=console|json|csv] [--min_time=seconds] [--filter=text] [--out=file]" << std::endl;
+        std::cout << "Runs every benchmark whose name contains the filter for at least min_time seconds (default 0.5)." << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    auto format = OutputFormat::CONSOLE;
+    double min_time = 0.5;
+    std::string filter;
+    std::string out_path;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        auto value = argument.substr(argument.find('=') + 1);
+
+        if (argument.rfind("--format=", 0) == 0) {
+            if (value == "json") {
+                format = OutputFormat::JSON;
+            } else if (value == "csv") {
+                format = OutputFormat::CSV;
+            } else if (value == "console") {
+                format = OutputFormat::CONSOLE;
+            } else {
+                print_usage();
+                return 1;
+            }
+        } else if (argument.rfind("--min_time=", 0) == 0) {
+            min_time = std::stod(value);
+        } else if (argument.rfind("--filter=", 0) == 0) {
+            filter = value;
+        } else if (argument.rfind("--out=", 0) == 0) {
+            out_path = value;
+        } else {
+            print_usage();
+            return argument == "--help" ? 0 : 1;
+        }
+    }
+
+    auto positions = create_positions();
+
+    BenchmarkRunner runner{min_time, filter};
+    add_benchmarks(runner, positions);
+
+    auto results = runner.run(std::cerr);
+
+    if (out_path.empty()) {
+        BenchmarkRunner::report(results, format, std::cout);
+    } else {
+        std::ofstream out(out_path);
+        BenchmarkRunner::report(results, format, out);
+    }
+
+    return 0;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "../gameboard/GameBoard.hpp"
+#include "../color/Color.hpp"
+#include "../position/Move.hpp"
+#include "../random/Random.hpp"
+
+// an opening book in the polyglot .bin format
+// the file is a sorted array of 16 byte entries (key, move, weight, learn), all big endian.
+// it is memory mapped and searched with a binary search, nothing is copied into memory
+class OpeningBook {
+    const uint8_t* data{nullptr};
+    size_t size{0};
+
+    [[nodiscard]] size_t entry_count() const;
+    [[nodiscard]] uint64_t key_at(size_t index) const;
+    [[nodiscard]] Move to_move(const GameBoard& board, uint16_t book_move) const;
+
+public:
+    OpeningBook() = default;
+    explicit OpeningBook(const std::string& path);
+    OpeningBook(const OpeningBook&) = delete;
+    OpeningBook& operator=(const OpeningBook&) = delete;
+    ~OpeningBook();
+
+    bool open(const std::string& path);
+    void close();
+
+    [[nodiscard]] bool is_open() const {
+        return data != nullptr;
+    }
+
+    [[nodiscard]] Move probe(GameBoard& board, Color side_to_move, Random& random) const;
+
+    [[nodiscard]] static uint64_t key(const GameBoard& board, Color side_to_move);
+};
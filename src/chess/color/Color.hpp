@@ -5,4 +5,13 @@ enum class Color {
     BLACK,
     DRAW,
     NONE
-};
\ No newline at end of file
+};
+
+/**
+ * Gets the color of the opponent.
+ * @param color The color of the player.
+ * @return The color of the other player.
+ */
+[[nodiscard]] constexpr Color enemy_of(Color color) {
+    return (color == Color::WHITE) ? Color::BLACK : Color::WHITE;
+}
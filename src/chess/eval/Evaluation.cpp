@@ -0,0 +1,287 @@
+#include "Evaluation.hpp"
+#include "../stats/Stats.hpp"
+#include <cmath>
+#include <iomanip>
+
+namespace {
+    constexpr int PIECE_VALUES[6] = {100, 320, 330, 500, 900, 0};
+
+    // game phase weight of every piece type, 24 is the phase of the starting position
+    constexpr int PHASE_WEIGHTS[6] = {0, 1, 1, 2, 4, 0};
+    constexpr int MAX_PHASE = 24;
+
+    // the tables are written from the perspective of white,
+    // with the 8th row at the top, just like the printed gameboard
+    constexpr int PAWN_TABLE[64] = {
+         0,  0,  0,  0,  0,  0,  0,  0,
+        50, 50, 50, 50, 50, 50, 50, 50,
+        10, 10, 20, 30, 30, 20, 10, 10,
+         5,  5, 10, 25, 25, 10,  5,  5,
+         0,  0,  0, 20, 20,  0,  0,  0,
+         5, -5,-10,  0,  0,-10, -5,  5,
+         5, 10, 10,-20,-20, 10, 10,  5,
+         0,  0,  0,  0,  0,  0,  0,  0
+    };
+
+    constexpr int KNIGHT_TABLE[64] = {
+        -50,-40,-30,-30,-30,-30,-40,-50,
+        -40,-20,  0,  0,  0,  0,-20,-40,
+        -30,  0, 10, 15, 15, 10,  0,-30,
+        -30,  5, 15, 20, 20, 15,  5,-30,
+        -30,  0, 15, 20, 20, 15,  0,-30,
+        -30,  5, 10, 15, 15, 10,  5,-30,
+        -40,-20,  0,  5,  5,  0,-20,-40,
+        -50,-40,-30,-30,-30,-30,-40,-50
+    };
+
+    constexpr int BISHOP_TABLE[64] = {
+        -20,-10,-10,-10,-10,-10,-10,-20,
+        -10,  0,  0,  0,  0,  0,  0,-10,
+        -10,  0,  5, 10, 10,  5,  0,-10,
+        -10,  5,  5, 10, 10,  5,  5,-10,
+        -10,  0, 10, 10, 10, 10,  0,-10,
+        -10, 10, 10, 10, 10, 10, 10,-10,
+        -10,  5,  0,  0,  0,  0,  5,-10,
+        -20,-10,-10,-10,-10,-10,-10,-20
+    };
+
+    constexpr int ROOK_TABLE[64] = {
+         0,  0,  0,  0,  0,  0,  0,  0,
+         5, 10, 10, 10, 10, 10, 10,  5,
+        -5,  0,  0,  0,  0,  0,  0, -5,
+        -5,  0,  0,  0,  0,  0,  0, -5,
+        -5,  0,  0,  0,  0,  0,  0, -5,
+        -5,  0,  0,  0,  0,  0,  0, -5,
+        -5,  0,  0,  0,  0,  0,  0, -5,
+         0,  0,  0,  5,  5,  0,  0,  0
+    };
+
+    constexpr int QUEEN_TABLE[64] = {
+        -20,-10,-10, -5, -5,-10,-10,-20,
+        -10,  0,  0,  0,  0,  0,  0,-10,
+        -10,  0,  5,  5,  5,  5,  0,-10,
+         -5,  0,  5,  5,  5,  5,  0, -5,
+          0,  0,  5,  5,  5,  5,  0, -5,
+        -10,  5,  5,  5,  5,  5,  0,-10,
+        -10,  0,  5,  0,  0,  0,  0,-10,
+        -20,-10,-10, -5, -5,-10,-10,-20
+    };
+
+    constexpr int KING_MIDDLE_GAME_TABLE[64] = {
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -20,-30,-30,-40,-40,-30,-30,-20,
+        -10,-20,-20,-20,-20,-20,-20,-10,
+         20, 20,  0,  0,  0,  0, 20, 20,
+         20, 30, 10,  0,  0, 10, 30, 20
+    };
+
+    constexpr int KING_END_GAME_TABLE[64] = {
+        -50,-40,-30,-20,-20,-30,-40,-50,
+        -30,-20,-10,  0,  0,-10,-20,-30,
+        -30,-10, 20, 30, 30, 20,-10,-30,
+        -30,-10, 30, 40, 40, 30,-10,-30,
+        -30,-10, 30, 40, 40, 30,-10,-30,
+        -30,-10, 20, 30, 30, 20,-10,-30,
+        -30,-30,  0,  0,  0,  0,-30,-30,
+        -50,-30,-30,-30,-30,-30,-30,-50
+    };
+
+    constexpr const int* PIECE_TABLES[5] = {PAWN_TABLE, KNIGHT_TABLE, BISHOP_TABLE, ROOK_TABLE, QUEEN_TABLE};
+
+    constexpr const char* TABLE_NAMES[5] = {"PAWN_TABLE", "KNIGHT_TABLE", "BISHOP_TABLE", "ROOK_TABLE", "QUEEN_TABLE"};
+
+    // the first parameter of every group in the dense vector of parameters
+    constexpr int VALUE_PARAMETERS = 0;
+    constexpr int TABLE_PARAMETERS = 5;
+    constexpr int KING_MIDDLE_GAME_PARAMETERS = TABLE_PARAMETERS + 5 * 64;
+    constexpr int KING_END_GAME_PARAMETERS = KING_MIDDLE_GAME_PARAMETERS + 64;
+
+    /**
+     * Writes a table of 64 values with 8 values per row, like the tables above.
+     */
+    void write_table(const char* name, std::span<const double> values, std::ostream& out) {
+        out << "    constexpr int " << name << "[64] = {" << std::endl;
+        for (int row = 0; row < 8; ++row) {
+            out << "        ";
+            for (int column = 0; column < 8; ++column) {
+                auto index = static_cast<size_t>(row * 8 + column);
+                out << std::setw(3) << std::lround(values[index]) << ((index < 63) ? "," : "");
+            }
+            out << std::endl;
+        }
+        out << "    };" << std::endl;
+    }
+}
+
+/**
+ * Evaluates the position from the perspective of the player to move.
+ * @param board The gameboard.
+ * @param side_to_move The color of the player to move.
+ * @return The score in centipawns, positive if the player to move is better.
+ */
+int Evaluation::evaluate(const GameBoard& board, Color side_to_move) {
+    STATS_TIMER(EVALUATION);
+
+    int score = 0;
+    int king_middle_game = 0;
+    int king_end_game = 0;
+    int phase = 0;
+
+    for (int x = 0; x < 8; ++x) {
+        for (int y = 0; y < 8; ++y) {
+            auto piece = board.get_piece({x, y});
+            if (!piece) {
+                continue;
+            }
+
+            auto color = piece->get_color();
+            auto type = ChessPiece::get_type_index(piece->get_name());
+            auto absolute = board.absolute({x, y});
+
+            // index into the tables from the perspective of the piece owner
+            auto row = (color == Color::WHITE) ? 7 - absolute.get_x() : absolute.get_x();
+            auto index = row * 8 + absolute.get_y();
+            auto sign = (color == side_to_move) ? 1 : -1;
+
+            phase += PHASE_WEIGHTS[type];
+
+            if (type == 5) {
+                king_middle_game += sign * KING_MIDDLE_GAME_TABLE[index];
+                king_end_game += sign * KING_END_GAME_TABLE[index];
+            } else {
+                score += sign * (PIECE_VALUES[type] + PIECE_TABLES[type][index]);
+            }
+        }
+    }
+
+    phase = std::min(phase, MAX_PHASE);
+    score += (king_middle_game * phase + king_end_game * (MAX_PHASE - phase)) / MAX_PHASE;
+
+    return score;
+}
+
+/**
+ * Gets the material value of a piece.
+ * @param name The name of the piece.
+ * @return The value in centipawns, 0 for the king.
+ */
+int Evaluation::piece_value(char name) {
+    auto type = ChessPiece::get_type_index(name);
+    return (type >= 0) ? PIECE_VALUES[type] : 0;
+}
+
+/**
+ * Checks if the player has any pieces besides pawns and the king.
+ * Used to avoid null move pruning in pawn endings, where zugzwang is common.
+ */
+bool Evaluation::has_non_pawn_material(const GameBoard& board, Color color) {
+    for (int x = 0; x < 8; ++x) {
+        for (int y = 0; y < 8; ++y) {
+            auto piece = board.get_piece({x, y});
+            if (piece && piece->get_color() == color && piece->get_name() != 'P' && piece->get_name() != 'K') {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @return The current parameters of the evaluation as a dense vector.
+ */
+std::vector<double> Evaluation::get_parameters() {
+    std::vector<double> parameters(NUM_PARAMETERS);
+
+    for (int type = 0; type < 5; ++type) {
+        parameters[VALUE_PARAMETERS + type] = PIECE_VALUES[type];
+        for (int index = 0; index < 64; ++index) {
+            parameters[static_cast<size_t>(TABLE_PARAMETERS + type * 64 + index)] = PIECE_TABLES[type][index];
+        }
+    }
+
+    for (int index = 0; index < 64; ++index) {
+        parameters[static_cast<size_t>(KING_MIDDLE_GAME_PARAMETERS + index)] = KING_MIDDLE_GAME_TABLE[index];
+        parameters[static_cast<size_t>(KING_END_GAME_PARAMETERS + index)] = KING_END_GAME_TABLE[index];
+    }
+
+    return parameters;
+}
+
+/**
+ * Gets the coefficients of the parameters in the position, the evaluation from the perspective of white
+ * is the sum of the parameters multiplied with their coefficients.
+ * It is the same as evaluate, except for the rounding of the king tables.
+ * @param board The gameboard.
+ * @param features The parameters with a coefficient other than 0 are appended.
+ */
+void Evaluation::get_features(const GameBoard& board, std::vector<EvalFeature>& features) {
+    float coefficients[NUM_PARAMETERS]{};
+    int phase = 0;
+
+    for (int x = 0; x < 8; ++x) {
+        for (int y = 0; y < 8; ++y) {
+            auto piece = board.get_piece({x, y});
+            if (!piece) {
+                continue;
+            }
+
+            auto color = piece->get_color();
+            auto type = ChessPiece::get_type_index(piece->get_name());
+            auto absolute = board.absolute({x, y});
+
+            auto row = (color == Color::WHITE) ? 7 - absolute.get_x() : absolute.get_x();
+            auto index = row * 8 + absolute.get_y();
+            auto sign = (color == Color::WHITE) ? 1.0f : -1.0f;
+
+            phase += PHASE_WEIGHTS[type];
+
+            if (type == 5) {
+                coefficients[KING_MIDDLE_GAME_PARAMETERS + index] += sign;
+                coefficients[KING_END_GAME_PARAMETERS + index] += sign;
+            } else {
+                coefficients[VALUE_PARAMETERS + type] += sign;
+                coefficients[TABLE_PARAMETERS + type * 64 + index] += sign;
+            }
+        }
+    }
+
+    // the king tables are blended by the phase
+    auto middle_game = static_cast<float>(std::min(phase, MAX_PHASE)) / MAX_PHASE;
+    for (int index = 0; index < 64; ++index) {
+        coefficients[KING_MIDDLE_GAME_PARAMETERS + index] *= middle_game;
+        coefficients[KING_END_GAME_PARAMETERS + index] *= 1.0f - middle_game;
+    }
+
+    for (int i = 0; i < NUM_PARAMETERS; ++i) {
+        if (coefficients[i] != 0.0f) {
+            features.push_back({static_cast<uint16_t>(i), coefficients[i]});
+        }
+    }
+}
+
+/**
+ * Writes the parameters as the C++ source of the tables at the top of this file.
+ * @param parameters A dense vector of NUM_PARAMETERS parameters.
+ * @param out The source is written to this stream.
+ */
+void Evaluation::write_parameters(std::span<const double> parameters, std::ostream& out) {
+    out << "    constexpr int PIECE_VALUES[6] = {";
+    for (int type = 0; type < 5; ++type) {
+        out << std::lround(parameters[static_cast<size_t>(VALUE_PARAMETERS + type)]) << ", ";
+    }
+    out << "0};" << std::endl;
+
+    for (int type = 0; type < 5; ++type) {
+        out << std::endl;
+        write_table(TABLE_NAMES[type], parameters.subspan(static_cast<size_t>(TABLE_PARAMETERS + type * 64), 64), out);
+    }
+
+    out << std::endl;
+    write_table("KING_MIDDLE_GAME_TABLE", parameters.subspan(KING_MIDDLE_GAME_PARAMETERS, 64), out);
+    out << std::endl;
+    write_table("KING_END_GAME_TABLE", parameters.subspan(KING_END_GAME_PARAMETERS, 64), out);
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <vector>
+#include "../gameboard/GameBoard.hpp"
+#include "../color/Color.hpp"
+
+// the coefficient of one parameter of the evaluation in a position
+struct EvalFeature {
+    uint16_t index;
+    float coefficient;
+};
+
+// static evaluation of a position for the search
+// material and piece square tables, the king table is blended
+// from middle game to end game depending on the material left on the board
+//
+// the evaluation is linear in its parameters, which are numbered as a dense vector for tuning:
+// the values of the pieces without the king, the piece square tables of pawn to queen,
+// and the middle game and end game tables of the king
+class Evaluation {
+public:
+    static constexpr int NUM_PARAMETERS = 5 + 5 * 64 + 2 * 64;
+
+    [[nodiscard]] static int evaluate(const GameBoard& board, Color side_to_move);
+    [[nodiscard]] static int piece_value(char name);
+    [[nodiscard]] static bool has_non_pawn_material(const GameBoard& board, Color color);
+
+    [[nodiscard]] static std::vector<double> get_parameters();
+    static void get_features(const GameBoard& board, std::vector<EvalFeature>& features);
+    static void write_parameters(std::span<const double> parameters, std::ostream& out);
+};
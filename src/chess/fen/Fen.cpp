@@ -0,0 +1,537 @@
+#include "Fen.hpp"
+#include "../movegen/MoveGen.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    constexpr int MAX_FIELDS = 6;
+
+    // the move counters are stored with 16 bits, see PackedPosition, no game comes close to it
+    constexpr int MAX_COUNTER = 65535;
+
+    /**
+     * Splits the text at spaces into at most max_fields fields, the last field keeps the rest of the text.
+     * @return The number of fields.
+     */
+    int split(std::string_view text, std::string_view (&fields)[MAX_FIELDS], int max_fields = MAX_FIELDS) {
+        int count = 0;
+        size_t position = 0;
+
+        while (count < max_fields) {
+            position = text.find_first_not_of(" \t\r\n", position);
+            if (position == std::string_view::npos) {
+                break;
+            }
+
+            auto end = (count == max_fields - 1) ? text.size() : text.find_first_of(" \t\r\n", position);
+            end = (end == std::string_view::npos) ? text.size() : end;
+            fields[count++] = text.substr(position, end - position);
+            position = end;
+        }
+
+        return count;
+    }
+
+    std::string_view trim(std::string_view text) {
+        auto begin = text.find_first_not_of(" \t\r\n");
+        if (begin == std::string_view::npos) {
+            return {};
+        }
+        auto end = text.find_last_not_of(" \t\r\n");
+        return text.substr(begin, end - begin + 1);
+    }
+
+    bool is_number(std::string_view text) {
+        return !text.empty() && text.find_first_not_of("0123456789") == std::string_view::npos;
+    }
+
+    std::unique_ptr<ChessPiece> create_piece(char symbol) {
+        auto color = std::isupper(static_cast<unsigned char>(symbol)) ? Color::WHITE : Color::BLACK;
+
+        switch (std::toupper(static_cast<unsigned char>(symbol))) {
+            case 'K': return make_unique<King>(color);
+            case 'Q': return make_unique<Queen>(color);
+            case 'R': return make_unique<Rook>(color);
+            case 'B': return make_unique<Bishop>(color);
+            case 'N': return make_unique<Knight>(color);
+            case 'P': return make_unique<Pawn>(color);
+            default: return nullptr;
+        }
+    }
+
+    std::invalid_argument invalid(const std::string& reason, std::string_view fen) {
+        return std::invalid_argument("Invalid FEN (" + reason + "): " + std::string(fen));
+    }
+
+    /**
+     * Reads one of the move counters.
+     * @param text The digits of the counter.
+     * @param name The name of the field for the error message.
+     * @throws std::invalid_argument if the counter is larger than MAX_COUNTER.
+     */
+    int parse_counter(std::string_view text, const std::string& name, std::string_view fen) {
+        int value = 0;
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (error != std::errc{} || end != text.data() + text.size() || value > MAX_COUNTER) {
+            throw invalid(name + " out of range", fen);
+        }
+        return value;
+    }
+}
+
+// *****************************************************
+// Public Methods
+// *****************************************************
+
+/**
+ * Creates a gameboard from a FEN or EPD string.
+ * The board is oriented for the player to move, like in the game.
+ * @param fen The position, the move counters are optional.
+ * @param side_to_move Set to the color of the player to move.
+ * @return The gameboard.
+ * @throws std::invalid_argument if the string is not a valid position.
+ */
+GameBoard Fen::parse(std::string_view fen, Color& side_to_move) {
+    std::string_view fields[MAX_FIELDS];
+    auto count = split(fen, fields);
+
+    if (count < 4) {
+        throw invalid("less than 4 fields", fen);
+    }
+
+    char pieces[8][8];
+    int rank = 7;
+    int file = 0;
+
+    for (auto& row : pieces) {
+        for (auto& piece : row) {
+            piece = ' ';
+        }
+    }
+
+    for (auto symbol : fields[0]) {
+        if (symbol == '/') {
+            if (file != 8 || rank == 0) {
+                throw invalid("wrong number of fields in a rank", fen);
+            }
+            --rank;
+            file = 0;
+        } else if (symbol >= '1' && symbol <= '8') {
+            file += symbol - '0';
+        } else {
+            if (!std::strchr("KQRBNPkqrbnp", symbol) || file >= 8) {
+                throw invalid("unknown piece or too many pieces in a rank", fen);
+            }
+            pieces[rank][file++] = symbol;
+        }
+
+        if (file > 8) {
+            throw invalid("too many fields in a rank", fen);
+        }
+    }
+
+    if (rank != 0 || file != 8) {
+        throw invalid("wrong number of ranks", fen);
+    }
+
+    if (fields[1] != "w" && fields[1] != "b") {
+        throw invalid("unknown player to move", fen);
+    }
+    side_to_move = (fields[1] == "w") ? Color::WHITE : Color::BLACK;
+
+    // besides KQkq the files of the rooks are accepted for chess960, like HAha in Shredder-FEN,
+    // or a file in X-FEN for a rook that is not the outermost one on its side.
+    // a file always makes it a chess960 board, even with the king and rooks on their standard fields
+    auto castling = fields[2];
+    if (castling != "-" && castling.find_first_not_of("KQkqABCDEFGHabcdefgh") != std::string_view::npos) {
+        throw invalid("unknown castling rights", fen);
+    }
+
+    auto castling_rights = 0;
+    int castling_files[2]{-1, -1};
+    auto chess960 = false;
+
+    for (auto right : castling) {
+        if (right == '-') {
+            continue;
+        }
+
+        auto white = std::isupper(static_cast<unsigned char>(right)) != 0;
+        auto letter = static_cast<char>(std::toupper(static_cast<unsigned char>(right)));
+        auto side = (letter == 'Q') ? QUEEN_SIDE : KING_SIDE;
+
+        if (letter != 'K' && letter != 'Q') {
+            auto home_rank = white ? 0 : 7;
+            auto king = std::find(std::begin(pieces[home_rank]), std::end(pieces[home_rank]), white ? 'K' : 'k');
+            if (king == std::end(pieces[home_rank])) {
+                throw invalid("castling without a king on the home rank", fen);
+            }
+
+            auto rook_file = letter - 'A';
+            side = (rook_file > king - std::begin(pieces[home_rank])) ? KING_SIDE : QUEEN_SIDE;
+            if (castling_files[side] >= 0 && castling_files[side] != rook_file) {
+                throw invalid("two castling rooks for one side", fen);
+            }
+            castling_files[side] = rook_file;
+            chess960 = true;
+        }
+
+        if (white) {
+            castling_rights |= (side == KING_SIDE) ? WHITE_KING_SIDE : WHITE_QUEEN_SIDE;
+        } else {
+            castling_rights |= (side == KING_SIDE) ? BLACK_KING_SIDE : BLACK_QUEEN_SIDE;
+        }
+    }
+
+    auto en_passant = fields[3];
+    auto en_passant_file = -1;
+    if (en_passant != "-") {
+        if (en_passant.size() != 2 || en_passant[0] < 'a' || en_passant[0] > 'h' ||
+            en_passant[1] != (side_to_move == Color::WHITE ? '6' : '3')) {
+            throw invalid("unknown en passant field", fen);
+        }
+        en_passant_file = en_passant[0] - 'a';
+    }
+
+    // the counters are optional, an EPD line has its operations there instead
+    auto halfmove_clock = 0;
+    if (count >= 5 && is_number(fields[4])) {
+        halfmove_clock = parse_counter(fields[4], "halfmove clock", fen);
+
+        auto fullmove = (count >= 6) ? fields[5].substr(0, fields[5].find_first_of(" \t\r\n")) : std::string_view{};
+        if (is_number(fullmove)) {
+            (void) parse_counter(fullmove, "fullmove number", fen);
+        }
+    }
+
+    try {
+        return create(pieces, side_to_move, castling_rights, en_passant_file, halfmove_clock,
+                      castling_files[QUEEN_SIDE], castling_files[KING_SIDE], chess960);
+    } catch (const std::invalid_argument& e) {
+        throw invalid(e.what(), fen);
+    }
+}
+
+/**
+ * Creates a gameboard from its pieces and the state that is not visible on the board.
+ * Used for every format that stores positions, not only FEN.
+ * @param pieces The pieces in the absolute orientation, indexed by rank and file,
+ *               with the letters of FEN (uppercase for white) and a space for an empty field.
+ * @param side_to_move The color of the player to move.
+ * @param castling_rights The castling rights as bits of CastlingRight.
+ * @param en_passant_file The file of the pawn that just moved two fields, -1 if there is none.
+ * @param halfmove_clock The half moves since the last capture or pawn move.
+ * @param queen_side_file The file of the rook castling to the queen side, -1 for the outermost rook on that side of the king.
+ * @param king_side_file The file of the rook castling to the king side, -1 for the outermost rook on that side of the king.
+ * @param chess960 true for a chess960 board, a king or a castling rook off the standard fields makes it one anyway.
+ * @return The gameboard, oriented for the player to move.
+ * @throws std::invalid_argument if a piece is unknown, a player does not have exactly one king,
+ *                               a pawn stands on the first or last rank or the player not to move is in check.
+ */
+GameBoard Fen::create(const char (&pieces)[8][8], Color side_to_move, int castling_rights, int en_passant_file, int halfmove_clock,
+                      int queen_side_file, int king_side_file, bool chess960) {
+    GameBoard board{GameTest::EMPTY};
+    board.chess960 = chess960;
+    int kings[2]{};
+
+    // find the rooks that castle, a right without a king and a rook on the home rank is dropped.
+    // a king or a rook off the standard fields makes it a chess960 board
+    const int requested_files[2]{queen_side_file, king_side_file};
+    int castling_files[2]{-1, -1};
+    int rights = 0;
+
+    for (auto white : {true, false}) {
+        auto home_rank = white ? 0 : 7;
+        auto king = std::find(std::begin(pieces[home_rank]), std::end(pieces[home_rank]), white ? 'K' : 'k');
+        if (king == std::end(pieces[home_rank])) {
+            continue;
+        }
+
+        auto king_file = static_cast<int>(king - std::begin(pieces[home_rank]));
+
+        for (auto side : {QUEEN_SIDE, KING_SIDE}) {
+            auto right = white ? ((side == KING_SIDE) ? WHITE_KING_SIDE : WHITE_QUEEN_SIDE)
+                               : ((side == KING_SIDE) ? BLACK_KING_SIDE : BLACK_QUEEN_SIDE);
+            if (!(castling_rights & right)) {
+                continue;
+            }
+
+            auto step = (side == KING_SIDE) ? -1 : 1;
+            auto rook_file = -1;
+            for (auto file = (side == KING_SIDE) ? 7 : 0; file != king_file; file += step) {
+                if (pieces[home_rank][file] == (white ? 'R' : 'r') && (requested_files[side] < 0 || requested_files[side] == file)) {
+                    rook_file = file;
+                    break;
+                }
+            }
+
+            if (rook_file < 0) {
+                continue;
+            }
+            if (castling_files[side] >= 0 && castling_files[side] != rook_file) {
+                throw std::invalid_argument("the castling rooks of both players stand on different files");
+            }
+
+            castling_files[side] = rook_file;
+            rights |= right;
+            board.chess960 = board.chess960 || king_file != 4 || rook_file != ((side == KING_SIDE) ? 7 : 0);
+        }
+    }
+
+    for (auto side : {QUEEN_SIDE, KING_SIDE}) {
+        if (castling_files[side] >= 0) {
+            board.castling_files[side] = castling_files[side];
+        }
+    }
+
+    for (int x = 0; x < 8; ++x) {
+        for (int y = 0; y < 8; ++y) {
+            if (pieces[x][y] == ' ') {
+                continue;
+            }
+
+            auto piece = create_piece(pieces[x][y]);
+            if (!piece) {
+                throw std::invalid_argument("unknown piece");
+            }
+
+            if (piece->get_name() == 'P' && (x == 0 || x == 7)) {
+                throw std::invalid_argument("pawn on the first or last rank");
+            }
+
+            auto white = piece->get_color() == Color::WHITE;
+            auto home_rank = white ? 0 : 7;
+            auto has_right = [rights, white](int white_right, int black_right) {
+                return (rights & (white ? white_right : black_right)) != 0;
+            };
+
+            // the board only knows if kings, rooks and pawns have moved,
+            // so the pieces that lost their castling rights count as moved
+            switch (piece->get_name()) {
+                case 'K': {
+                    ++kings[white ? 0 : 1];
+                    auto can_castle = x == home_rank &&
+                                      (has_right(WHITE_KING_SIDE, BLACK_KING_SIDE) || has_right(WHITE_QUEEN_SIDE, BLACK_QUEEN_SIDE));
+                    dynamic_cast<King*>(piece.get())->set_moved(!can_castle);
+                    break;
+                }
+                case 'R': {
+                    auto can_castle = x == home_rank &&
+                                      ((y == castling_files[KING_SIDE] && has_right(WHITE_KING_SIDE, BLACK_KING_SIDE)) ||
+                                       (y == castling_files[QUEEN_SIDE] && has_right(WHITE_QUEEN_SIDE, BLACK_QUEEN_SIDE)));
+                    dynamic_cast<Rook*>(piece.get())->set_moved(!can_castle);
+                    break;
+                }
+                case 'P':
+                    dynamic_cast<Pawn*>(piece.get())->set_moved(x != (white ? 1 : 6));
+                    break;
+                default:
+                    break;
+            }
+
+            board.board[x][y] = std::move(piece);
+        }
+    }
+
+    if (kings[0] != 1 || kings[1] != 1) {
+        throw std::invalid_argument("every player needs exactly one king");
+    }
+
+    // the player to move could capture the king
+    if (MoveGen::in_check(board, enemy_of(side_to_move))) {
+        throw std::invalid_argument("the player not to move is in check");
+    }
+
+    // the pawn that moved two fields is the last move of the board, the opponent of the player to move made it
+    if (en_passant_file >= 0 && en_passant_file < 8) {
+        auto white_moved = side_to_move == Color::BLACK;
+        auto from = Position(white_moved ? 1 : 6, en_passant_file);
+        auto to = Position(white_moved ? 3 : 4, en_passant_file);
+        auto pawn = board.get_piece(to);
+
+        if (pawn && pawn->get_name() == 'P' && pawn->get_color() == (white_moved ? Color::WHITE : Color::BLACK)) {
+            board.last_move = LastMove('P', from, to);
+        }
+    }
+
+    board.halfmove_clock = halfmove_clock;
+
+    if (side_to_move == Color::BLACK) {
+        board.flip();
+    }
+
+    return board;
+}
+
+/**
+ * Writes the position as FEN.
+ * @param board The gameboard, in any orientation.
+ * @param side_to_move The color of the player to move.
+ * @param fullmove_number The number of the move, the board does not know it.
+ * @return The FEN string.
+ */
+std::string Fen::to_string(const GameBoard& board, Color side_to_move, int fullmove_number) {
+    std::string result;
+
+    for (int rank = 7; rank >= 0; --rank) {
+        int empty = 0;
+
+        for (int file = 0; file < 8; ++file) {
+            auto piece = board.get_piece(board.absolute({rank, file}));
+
+            if (!piece) {
+                ++empty;
+                continue;
+            }
+
+            if (empty) {
+                result += static_cast<char>('0' + empty);
+                empty = 0;
+            }
+
+            auto name = piece->get_name();
+            result += (piece->get_color() == Color::WHITE) ? name : static_cast<char>(std::tolower(name));
+        }
+
+        if (empty) {
+            result += static_cast<char>('0' + empty);
+        }
+        if (rank > 0) {
+            result += '/';
+        }
+    }
+
+    result += (side_to_move == Color::WHITE) ? " w " : " b ";
+
+    // a chess960 board writes the files of the castling rooks like Shredder-FEN, so it is read as chess960 again,
+    // even with the king and the rooks on the standard fields
+    auto castling_letter = [&board](bool white, CastlingSide side) {
+        auto letter = board.chess960 ? static_cast<char>('A' + board.get_castling_file(side))
+                                     : (side == KING_SIDE) ? 'K' : 'Q';
+        return white ? letter : static_cast<char>(std::tolower(letter));
+    };
+
+    auto rights = board.get_castling_rights();
+    if (!rights) {
+        result += '-';
+    }
+    if (rights & WHITE_KING_SIDE) result += castling_letter(true, KING_SIDE);
+    if (rights & WHITE_QUEEN_SIDE) result += castling_letter(true, QUEEN_SIDE);
+    if (rights & BLACK_KING_SIDE) result += castling_letter(false, KING_SIDE);
+    if (rights & BLACK_QUEEN_SIDE) result += castling_letter(false, QUEEN_SIDE);
+
+    auto en_passant_file = board.get_en_passant_file(side_to_move);
+    if (en_passant_file >= 0) {
+        result += ' ';
+        result += static_cast<char>('a' + en_passant_file);
+        result += (side_to_move == Color::WHITE) ? '6' : '3';
+    } else {
+        result += " -";
+    }
+
+    result += ' ' + std::to_string(board.get_halfmove_clock()) + ' ' + std::to_string(fullmove_number);
+    return result;
+}
+
+/**
+ * Creates the FEN of a chess960 start position.
+ * The positions are numbered like Scharnagl did: the number picks the fields of both bishops,
+ * then the queen and the knights, the king stands between the rooks on the remaining fields.
+ * @param number The number of the position from 0 to 959, 518 is the normal start position.
+ * @return The FEN, white to move.
+ * @throws std::invalid_argument if the number is out of range.
+ */
+std::string Fen::chess960(int number) {
+    if (number < 0 || number >= CHESS960_POSITIONS) {
+        throw std::invalid_argument("Invalid chess960 position: " + std::to_string(number));
+    }
+
+    // the five remaining fields of the knights, by the last digit of the number
+    constexpr int KNIGHTS[10][2] = {{0, 1}, {0, 2}, {0, 3}, {0, 4}, {1, 2}, {1, 3}, {1, 4}, {2, 3}, {2, 4}, {3, 4}};
+
+    char row[9] = "        ";
+    auto place_on_empty = [&row](int index, char piece) {
+        for (auto& field : row) {
+            if (field == ' ' && index-- == 0) {
+                field = piece;
+                return;
+            }
+        }
+    };
+
+    row[2 * (number % 4) + 1] = 'B'; // a bishop on a light field
+    number /= 4;
+    row[2 * (number % 4)] = 'B';     // and one on a dark field
+    number /= 4;
+    place_on_empty(number % 6, 'Q');
+    number /= 6;
+
+    // the second knight is placed after the first one, which takes one of the empty fields before it
+    place_on_empty(KNIGHTS[number][0], 'N');
+    place_on_empty(KNIGHTS[number][1] - 1, 'N');
+
+    place_on_empty(0, 'R');
+    place_on_empty(0, 'K');
+    place_on_empty(0, 'R');
+
+    std::string white{row, 8};
+    std::string black;
+    for (auto piece : white) {
+        black += static_cast<char>(std::tolower(piece));
+    }
+
+    // the files of the rooks as castling rights, so the normal start position is read as chess960 as well
+    std::string castling{static_cast<char>('A' + white.rfind('R')), static_cast<char>('A' + white.find('R'))};
+    castling += static_cast<char>(std::tolower(castling[0]));
+    castling += static_cast<char>(std::tolower(castling[1]));
+
+    return black + "/pppppppp/8/8/8/8/PPPPPPPP/" + white + " w " + castling + " - 0 1";
+}
+
+/**
+ * Gets the operand of an EPD operation, like the name of the position for the opcode id.
+ * @param epd The EPD line.
+ * @param opcode The opcode of the operation.
+ * @return The operand without quotes, empty if the line has no such operation.
+ */
+std::string_view Fen::epd_operation(std::string_view epd, std::string_view opcode) {
+    std::string_view fields[MAX_FIELDS];
+
+    // the operations follow the four fields of the position
+    if (split(epd, fields, 5) < 5) {
+        return {};
+    }
+
+    auto operations = fields[4];
+
+    // a FEN with move counters followed by operations is accepted as well
+    for (int counter = 0; counter < 2; ++counter) {
+        auto end = operations.find(' ');
+        if (end == std::string_view::npos || !is_number(operations.substr(0, end))) {
+            break;
+        }
+        operations = trim(operations.substr(end + 1));
+    }
+
+    while (!operations.empty()) {
+        auto end = operations.find(';');
+        auto operation = trim(operations.substr(0, end));
+        operations = (end == std::string_view::npos) ? std::string_view{} : operations.substr(end + 1);
+
+        auto separator = operation.find(' ');
+        if (operation.substr(0, separator) != opcode) {
+            continue;
+        }
+
+        auto operand = (separator == std::string_view::npos) ? std::string_view{} : trim(operation.substr(separator + 1));
+        if (operand.size() >= 2 && operand.front() == '"' && operand.back() == '"') {
+            operand = operand.substr(1, operand.size() - 2);
+        }
+        return operand;
+    }
+
+    return {};
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include "../gameboard/GameBoard.hpp"
+#include "../color/Color.hpp"
+
+// reading and writing positions in the Forsyth-Edwards notation.
+// EPD lines are read as well, they have no move counters but operations like bm or id after the position.
+// chess960 positions are written with the rook files of Shredder-FEN as castling rights, X-FEN is read as well
+class Fen {
+public:
+    static constexpr const char* START_POSITION = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+    [[nodiscard]] static GameBoard parse(std::string_view fen, Color& side_to_move);
+    static constexpr int CHESS960_POSITIONS = 960;
+
+    [[nodiscard]] static GameBoard create(const char (&pieces)[8][8], Color side_to_move, int castling_rights,
+                                          int en_passant_file, int halfmove_clock,
+                                          int queen_side_file = -1, int king_side_file = -1, bool chess960 = false);
+    [[nodiscard]] static std::string to_string(const GameBoard& board, Color side_to_move, int fullmove_number = 1);
+    [[nodiscard]] static std::string chess960(int number);
+    [[nodiscard]] static std::string_view epd_operation(std::string_view epd, std::string_view opcode);
+};
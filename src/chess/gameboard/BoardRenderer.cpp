@@ -0,0 +1,134 @@
+#include "BoardRenderer.hpp"
+#include "GameBoard.hpp"
+#include <algorithm>
+
+namespace {
+    constexpr std::string_view CLEAR_SCREEN = "\x1B[2J\x1B[H";
+    constexpr std::string_view CURSOR_HOME = "\x1B[H";
+    constexpr std::string_view CLEAR_BELOW = "\x1B[J";
+    constexpr std::string_view SPLIT_ROW = "-----+-----+-----+-----+-----+-----+-----+-----+-----+-----\n";
+    constexpr std::string_view CHARACTER_ROW = "     |  A  |  B  |  C  |  D  |  E  |  F  |  G  |  H  |     \n";
+    constexpr std::string_view FLIPPED_CHARACTER_ROW = "     |  H  |  G  |  F  |  E  |  D  |  C  |  B  |  A  |     \n";
+
+    // the first line below the board, the frame has 19 lines followed by an empty line
+    constexpr int LINES = 21;
+
+    /**
+     * Appends the escape sequence that moves the cursor, line and column start at 1.
+     */
+    void move_cursor(std::string& frame, int line, int column) {
+        frame += "\x1B[";
+        frame += std::to_string(line);
+        frame += ';';
+        frame += std::to_string(column);
+        frame += 'H';
+    }
+}
+
+// *****************************************************
+// Public Methods
+// *****************************************************
+
+BoardRenderer::BoardRenderer(bool incremental) : incremental(incremental) {
+    // a full frame with escape sequences and symbols of 3 bytes is less than 2 kb
+    frame.reserve(2048);
+}
+
+/**
+ * Draws the gameboard, with the player to move at the bottom.
+ * @param board The gameboard.
+ * @param marked The fields to mark, like the valid moves of a piece.
+ * @param out The stream to write the frame to.
+ */
+void BoardRenderer::draw(const GameBoard& board, const VecPos& marked, std::ostream& out) {
+    bool is_marked[8][8]{};
+    for (const auto& position : marked) {
+        if (position.is_valid()) {
+            is_marked[position.get_x()][position.get_y()] = true;
+        }
+    }
+
+    Cell next[8][8];
+    for (int x = 0; x < 8; ++x) {
+        for (int y = 0; y < 8; ++y) {
+            auto piece = board.get_piece({x, y});
+            auto& cell = next[x][y];
+
+            cell.append(is_marked[x][y] ? " (" : "  ");
+            cell.append(piece ? piece->get_symbol() : " ");
+            cell.append(is_marked[x][y] ? ") " : "  ");
+        }
+    }
+
+    frame.clear();
+    if (!incremental || !has_frame) {
+        frame += CLEAR_SCREEN;
+        draw_full(board, next);
+    } else if (flipped != board.is_flipped()) {
+        // every line is overwritten in place, clearing the screen first would flicker
+        frame += CURSOR_HOME;
+        draw_full(board, next);
+        frame += CLEAR_BELOW;
+    } else {
+        draw_changes(next);
+    }
+
+    std::copy(&next[0][0], &next[0][0] + 64, &cells[0][0]);
+    flipped = board.is_flipped();
+    has_frame = true;
+
+    out.write(frame.data(), static_cast<std::streamsize>(frame.size()));
+    out.flush();
+}
+
+// *****************************************************
+// Private Methods
+// *****************************************************
+
+void BoardRenderer::draw_full(const GameBoard& board, const Cell (&next)[8][8]) {
+    const auto& character_row = board.is_flipped() ? FLIPPED_CHARACTER_ROW : CHARACTER_ROW;
+    auto row_number = board.is_flipped() ? 1 : 8;
+
+    frame += character_row;
+
+    for (int x = 7; x >= 0; --x) {
+        frame += SPLIT_ROW;
+        frame += "  ";
+        frame += static_cast<char>('0' + row_number);
+        frame += "  |";
+
+        for (int y = 0; y < 8; ++y) {
+            frame += next[x][y].view();
+            frame += '|';
+        }
+
+        frame += "  ";
+        frame += static_cast<char>('0' + row_number);
+        frame += '\n';
+        board.is_flipped() ? ++row_number : --row_number;
+    }
+
+    frame += SPLIT_ROW;
+    frame += character_row;
+    frame += '\n';
+}
+
+/**
+ * Redraws the fields that changed and clears the text written below the board since the last frame.
+ */
+void BoardRenderer::draw_changes(const Cell (&next)[8][8]) {
+    for (int x = 0; x < 8; ++x) {
+        for (int y = 0; y < 8; ++y) {
+            if (next[x][y].view() == cells[x][y].view()) {
+                continue;
+            }
+
+            // the row of x is line 3 + 2 * (7 - x), every field takes 6 columns after the row number
+            move_cursor(frame, 3 + 2 * (7 - x), 7 + 6 * y);
+            frame += next[x][y].view();
+        }
+    }
+
+    move_cursor(frame, LINES, 1);
+    frame += CLEAR_BELOW;
+}
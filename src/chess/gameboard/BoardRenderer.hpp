@@ -0,0 +1,53 @@
+#pragma once
+#include <algorithm>
+#include <iostream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include "../position/Position.hpp"
+
+class GameBoard;
+
+// draws the gameboard on an ansi terminal.
+// a frame is built in one buffer and written with a single write, so the terminal never shows half a board.
+// an incremental renderer remembers the last frame and only moves the cursor to the fields that changed,
+// which keeps the output small over slow connections
+class BoardRenderer {
+    // the text of a field without its border, like "  ♙  " or " (♙) " for a marked field
+    struct Cell {
+        char text[16]{};
+        size_t length{0};
+
+        void append(std::string_view characters) {
+            // a symbol is a single character, at most 4 bytes in utf-8
+            auto count = std::min(characters.size(), sizeof(text) - length);
+            characters.copy(text + length, count);
+            length += count;
+        }
+
+        [[nodiscard]] std::string_view view() const {
+            return {text, length};
+        }
+    };
+
+    bool incremental;
+    bool has_frame{false};
+    bool flipped{false};
+    Cell cells[8][8];
+    std::string frame;
+
+    void draw_full(const GameBoard& board, const Cell (&next)[8][8]);
+    void draw_changes(const Cell (&next)[8][8]);
+
+public:
+    explicit BoardRenderer(bool incremental = false);
+
+    void draw(const GameBoard& board, const VecPos& marked = {}, std::ostream& out = std::cout);
+
+    /**
+     * The next frame is drawn completely, for example after something else was written to the terminal.
+     */
+    void invalidate() {
+        has_frame = false;
+    }
+};
@@ -1,5 +1,20 @@
-#include <ranges>
 #include "GameBoard.hpp"
+#include "BoardRenderer.hpp"
+#include "../hash/Zobrist.hpp"
+#include "../movegen/MoveGen.hpp"
+#include "../stats/Stats.hpp"
+
+namespace {
+    // mirrors the fields of a KingSafety like flip mirrors the board, bit x * 8 + y becomes bit 63 - (x * 8 + y)
+    uint64_t mirror_fields(uint64_t fields) {
+        fields = ((fields >> 1) & 0x5555555555555555ULL) | ((fields & 0x5555555555555555ULL) << 1);
+        fields = ((fields >> 2) & 0x3333333333333333ULL) | ((fields & 0x3333333333333333ULL) << 2);
+        fields = ((fields >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((fields & 0x0F0F0F0F0F0F0F0FULL) << 4);
+        fields = ((fields >> 8) & 0x00FF00FF00FF00FFULL) | ((fields & 0x00FF00FF00FF00FFULL) << 8);
+        fields = ((fields >> 16) & 0x0000FFFF0000FFFFULL) | ((fields & 0x0000FFFF0000FFFFULL) << 16);
+        return (fields >> 32) | (fields << 32);
+    }
+}
 
 // *****************************************************
 // Public Methods
@@ -36,32 +51,58 @@ GameBoard::GameBoard(GameTest option) {
         case GameTest::CASTLING:
             init_castling();
             break;
+        case GameTest::EMPTY:
+            break;
     }
 }
 
-GameBoard::GameBoard(const GameBoard& other) {
+GameBoard::GameBoard(const GameBoard& other)
+    : flipped(other.flipped),
+      last_move(other.last_move),
+      en_passant_target(other.en_passant_target),
+      castling_targets(other.castling_targets),
+      halfmove_clock(other.halfmove_clock),
+      castling_files{other.castling_files[0], other.castling_files[1]},
+      chess960(other.chess960)
+{
+    STATS_INC(BOARD_COPIES);
+
     for (int i = 0; i < 8; ++i) {
         for (int j = 0; j < 8; ++j) {
             if (other.board[i][j] != nullptr) {
+                auto color = other.board[i][j]->get_color();
+                STATS_INC(ALLOCATIONS);
+
+                // the moved flags have to be copied as well,
+                // otherwise castling and the double step of pawns would be possible again on the copy
                 switch(other.board[i][j]->get_name()) {
-                    case 'K':
-                        board[i][j] = make_unique<King>(other.board[i][j]->get_color());
+                    case 'K': {
+                        auto king = make_unique<King>(color);
+                        king->set_moved(dynamic_cast<King*>(other.board[i][j].get())->has_moved());
+                        board[i][j] = std::move(king);
                         break;
+                    }
                     case 'Q':
-                        board[i][j] = make_unique<Queen>(other.board[i][j]->get_color());
+                        board[i][j] = make_unique<Queen>(color);
                         break;
-                    case 'R':
-                        board[i][j] = make_unique<Rook>(other.board[i][j]->get_color());
+                    case 'R': {
+                        auto rook = make_unique<Rook>(color);
+                        rook->set_moved(dynamic_cast<Rook*>(other.board[i][j].get())->has_moved());
+                        board[i][j] = std::move(rook);
                         break;
+                    }
                     case 'B':
-                        board[i][j] = make_unique<Bishop>(other.board[i][j]->get_color());
+                        board[i][j] = make_unique<Bishop>(color);
                         break;
                     case 'N':
-                        board[i][j] = make_unique<Knight>(other.board[i][j]->get_color());
+                        board[i][j] = make_unique<Knight>(color);
                         break;
-                    case 'P':
-                        board[i][j] = make_unique<Pawn>(other.board[i][j]->get_color());
+                    case 'P': {
+                        auto pawn = make_unique<Pawn>(color);
+                        pawn->set_moved(dynamic_cast<Pawn*>(other.board[i][j].get())->has_moved());
+                        board[i][j] = std::move(pawn);
                         break;
+                    }
                     default:
                         board[i][j] = nullptr;
                         break;
@@ -75,33 +116,7 @@ GameBoard::GameBoard(const GameBoard& other) {
  * Prints the current gameboard.
  */
 void GameBoard::print() const {
-    clear_screen();
-    std::string character_row = "     |  A  |  B  |  C  |  D  |  E  |  F  |  G  |  H  |     ";
-    std::string split_row = "-----+-----+-----+-----+-----+-----+-----+-----+-----+-----\n";
-    int row_number = (flipped) ? 1 : 8;
-
-    if (flipped) {
-        std::reverse(character_row.begin(), character_row.end());
-    }
-    character_row += "\n";
-
-    std::cout << character_row;
-
-    for (const auto& row : board | std::views::reverse) {
-
-        std::cout << split_row;
-        std::cout << "  " << row_number << "  |";
-
-        for (const auto & field : row) {
-            std::string symbol = (field ? field->get_symbol() : " ");
-            std::cout << "  " << symbol << "  |";
-        }
-
-        std::cout << "  " << row_number << std::endl;
-        (flipped) ? ++row_number : --row_number;
-    }
-
-    std::cout << split_row << character_row << std::endl;
+    BoardRenderer{}.draw(*this);
 }
 
 /**
@@ -109,45 +124,7 @@ void GameBoard::print() const {
  * @param valid_moves The valid moves for the given position.
  */
 void GameBoard::print(const VecPos& valid_moves) const {
-    clear_screen();
-    std::string character_row = "     |  A  |  B  |  C  |  D  |  E  |  F  |  G  |  H  |     ";
-    std::string split_row = "-----+-----+-----+-----+-----+-----+-----+-----+-----+-----\n";
-    int row_number = (flipped) ? 1 : 8;
-
-    if (flipped) {
-        std::reverse(character_row.begin(), character_row.end());
-    }
-    character_row += "\n";
-
-    std::cout << character_row;
-
-    for (auto x = 7; x >= 0; --x) {
-        const auto & row = board[x];
-
-        std::cout << split_row;
-        std::cout << "  " << row_number << "  |";
-
-        for (auto y = 0; y < 8; ++y) {
-            auto field = row[y].get();
-            std::string sym_prefix = "  ";
-            std::string sym_suffix = "  |";
-
-            for (const auto & move : valid_moves) {
-                if (move.get_x() == x && move.get_y() == y) {
-                    sym_prefix = " (";
-                    sym_suffix = ") |";
-                }
-            }
-
-            std::string symbol = (field ? field->get_symbol() : " ");
-            std::cout << sym_prefix << symbol << sym_suffix;
-        }
-
-        std::cout << "  " << row_number << std::endl;
-        (flipped) ? ++row_number : --row_number;
-    }
-
-    std::cout << split_row << character_row;
+    BoardRenderer{}.draw(*this, valid_moves);
 }
 
 /**
@@ -166,7 +143,11 @@ VecPos GameBoard::get_valid_moves_for(const Position position) {
     }
 
     // standard check for moves
-    auto moves = piece->get_moves_for(position, this->board);
+    VecPos moves;
+    {
+        STATS_TIMER(MOVE_GENERATION);
+        moves = piece->get_moves_for(position, this->board);
+    }
 
     {
         // check for en passant
@@ -186,51 +167,18 @@ VecPos GameBoard::get_valid_moves_for(const Position position) {
 
     validate_moves(position, piece, moves);
 
-    // we check for castling after validating the moves, because we validate the moves
-    // ourselves with some additional checks
-    {
-        VecPos left_castle_moves;
-        VecPos right_castle_moves;
-
-        if (piece->get_name() == 'K') {
-            auto color = piece->get_color();
-            bool left{true}, right{false};
-            // check for castling on the left side
-            left_castle_moves = King::get_castling(position, this->board, left, color, flipped);
-
-            // if validate_moves returns a vector smaller than 2, castling is not possible
-            // as the king would be in check
-            auto size = left_castle_moves.size();
-            validate_moves(position, piece, left_castle_moves);
-            if (left_castle_moves.size() != size) {
-                left_castle_moves.clear();
-            }
+    // castling is validated by the move generator of the engine,
+    // which also knows the rules of chess960 where the king may pass the rook or stay on its field
+    if (piece->get_name() == 'K') {
+        MoveList castling_moves;
+        MoveGen::generate_castling(*this, position, piece->get_color(), castling_moves);
 
-            // check for castling on the right side
-            right_castle_moves = King::get_castling(position, this->board, right, color, flipped);
+        // we also clear castling target, as we need to refill it with the correct targets for this turn
+        castling_targets.clear();
 
-            // if validate_moves returns a vector smaller than 2, castling is not possible
-            // as the king would be in check
-            size = right_castle_moves.size();
-            validate_moves(position, piece, right_castle_moves);
-            if (right_castle_moves.size() != size) {
-                right_castle_moves.clear();
-            }
-
-            // insert only the last move of the left and right castling moves
-            // as the king is the only piece that can move in castling,
-            // and it moves two fields
-            // we also clear castling target, as we need to refill it with the correct targets for this turn
-            castling_targets.clear();
-
-            if (!left_castle_moves.empty()) {
-                moves.push_back(left_castle_moves.back());
-                castling_targets.push_back(left_castle_moves.back());
-            }
-            if (!right_castle_moves.empty()) {
-                moves.push_back(right_castle_moves.back());
-                castling_targets.push_back(right_castle_moves.back());
-            }
+        for (const auto& move : castling_moves) {
+            moves.push_back(move.get_to());
+            castling_targets.push_back(move.get_to());
         }
     }
 
@@ -249,6 +197,9 @@ VecPos GameBoard::get_valid_moves_for(const Position position) {
  * @param moves The moves to validate.
  */
 void GameBoard::validate_moves(const Position &position, ChessPiece *piece, VecPos &moves) const {
+    STATS_TIMER(LEGALITY);
+    STATS_ADD(LEGAL_CHECKS, moves.size());
+
     auto piece_color = piece->get_color();
 
     auto iter = moves.begin();
@@ -268,28 +219,19 @@ void GameBoard::validate_moves(const Position &position, ChessPiece *piece, VecP
 }
 
 /**
- * Moves the piece from the given position to the given position.
- * @param current_player The color of the player that is moving.
+ * Checks if the king of the given color is in check, in either orientation of the board.
+ * The result is kept until the position changes, like the rest of the KingSafety.
+ * @param current_player The color of the king.
  */
 bool GameBoard::is_king_in_check(Color current_player) const {
-    King* king = nullptr;
-    Position king_pos;
-
-    // iterate over the board to find the king
-    // if the king was found create the king_pos
-    // break the loop
-    find_king(current_player, king, king_pos);
+    const auto& safety = MoveGen::king_safety(*this, current_player);
 
     // if the king was not found throw an exception as this should not happen
-    if (!king) {
+    if (!safety.king.is_valid()) {
         throw std::runtime_error("King not found");
     }
 
-    auto diagonalAttackers = king->get_diagonal_attackers(this->board, king_pos);
-    auto straightAttackers = king->get_straight_attackers(this->board, king_pos);
-    auto horseAttackers = king->get_horse_attackers(this->board, king_pos);
-
-    return king_in_check(current_player, king_pos, diagonalAttackers, straightAttackers, horseAttackers);
+    return safety.checkers != 0;
 }
 
 /**
@@ -360,6 +302,30 @@ void GameBoard::move_piece(Position old_pos, Position new_pos, bool not_tmp) {
     auto new_x = new_pos.get_x();
     auto new_y = new_pos.get_y();
 
+    clear_king_safety();
+
+    // castling moves the king and the rook at once, in chess960 the king may even land on the field of its rook
+    CastlingMove castling;
+    if (get_castling_move(old_pos, new_pos, castling)) {
+        ++halfmove_clock;
+        move_castling_pieces(castling, false);
+        dynamic_cast<King*>(board[castling.king_to.get_x()][castling.king_to.get_y()].get())->set_moved(true);
+        dynamic_cast<Rook*>(board[castling.rook_to.get_x()][castling.rook_to.get_y()].get())->set_moved(true);
+
+        if (not_tmp) {
+            last_move = LastMove{'K', old_pos, new_pos};
+        }
+        return;
+    }
+
+    // captures and pawn moves can not be undone, they reset the halfmove clock for the fifty move rule
+    auto en_passant = en_passant_target.is_valid() && en_passant_target == new_pos;
+    if (board[new_x][new_y] || en_passant || board[old_x][old_y]->get_name() == 'P') {
+        halfmove_clock = 0;
+    } else {
+        ++halfmove_clock;
+    }
+
     // check if there is a piece on the new position
     // if there is a piece on the new position, delete it
     if (board[new_x][new_y]) {
@@ -385,33 +351,12 @@ void GameBoard::move_piece(Position old_pos, Position new_pos, bool not_tmp) {
     }
 
     // if en passant target is valid and matches the new_pos, we need to delete the pawn which was captured
-    if (en_passant_target.is_valid() && en_passant_target == new_pos) {
+    if (en_passant) {
         // old_x is the row of the pawn which was captured
         // new_y is the column of the pawn which was captured
         board[old_x][new_y].reset();
     }
 
-    // extra check for castling
-    // if the piece moved is a king and the new position is two fields away from the old position
-    // we need to move the rook as well
-    if (board[old_x][old_y]->get_name() == 'K' && abs(new_y - old_y) == 2) {
-        // if the new position is two fields to the right of the old position
-        // we need to move the rook on the right side
-        if (new_y - old_y == 2) {
-            // move the rook to the right side
-            board[new_x][new_y - 1] = std::move(board[new_x][7]);
-            board[new_x][7].reset();
-        }
-
-            // if the new position is two fields to the left of the old position
-            // we need to move the rook on the left side
-        else {
-            // move the rook to the left side
-            board[new_x][new_y + 1] = std::move(board[new_x][0]);
-            board[new_x][0].reset();
-        }
-    }
-
     // move the piece
     board[new_x][new_y] = std::move(board[old_x][old_y]);
 
@@ -434,6 +379,180 @@ void GameBoard::move_piece(Position old_pos, Position new_pos, bool not_tmp) {
     }
 }
 
+/**
+ * Makes a move of the engine.
+ * Unlike move_piece this does not ask the player for input,
+ * the promotion piece is taken from the move itself.
+ * The board is not flipped, this is up to the caller.
+ * @param move The move to make.
+ */
+void GameBoard::make_move(const Move& move) {
+    auto from = move.get_from();
+    auto to = move.get_to();
+    auto piece = board[from.get_x()][from.get_y()].get();
+    auto name = piece->get_name();
+    auto color = piece->get_color();
+
+    // a pawn moving diagonally onto an empty field can only be an en passant capture
+    if (name == 'P' && from.get_y() != to.get_y() && !board[to.get_x()][to.get_y()]) {
+        en_passant_target = to;
+    } else {
+        en_passant_target = Position{};
+    }
+
+    move_piece(from, to, false);
+
+    if (move.get_promotion() != ' ') {
+        STATS_INC(ALLOCATIONS);
+    }
+
+    switch (move.get_promotion()) {
+        case 'Q':
+            board[to.get_x()][to.get_y()] = make_unique<Queen>(color);
+            break;
+        case 'R':
+            board[to.get_x()][to.get_y()] = make_unique<Rook>(color);
+            break;
+        case 'B':
+            board[to.get_x()][to.get_y()] = make_unique<Bishop>(color);
+            break;
+        case 'N':
+            board[to.get_x()][to.get_y()] = make_unique<Knight>(color);
+            break;
+        default:
+            break;
+    }
+
+    last_move = LastMove{name, from, to};
+}
+
+/**
+ * Passes the turn without moving a piece.
+ * Used by the null move pruning of the search, en passant is not possible afterwards.
+ * The board is not flipped, this is up to the caller.
+ */
+void GameBoard::make_null_move() {
+    clear_king_safety();
+    last_move = LastMove{' ', Position(-1, -1), Position(-1, -1)};
+    en_passant_target = Position{};
+}
+
+/**
+ * Gets the castling rights, derived from the kings and rooks that have not moved yet.
+ * @return The CastlingRight bits that are still available.
+ */
+int GameBoard::get_castling_rights() const {
+    auto unmoved = [this](int x, int y, char name, Color color) {
+        auto piece = get_piece(absolute({x, y}));
+        if (!piece || piece->get_name() != name || piece->get_color() != color) {
+            return false;
+        }
+        if (name == 'K') {
+            return !dynamic_cast<King*>(piece)->has_moved();
+        }
+        return !dynamic_cast<Rook*>(piece)->has_moved();
+    };
+
+    int rights = 0;
+
+    for (auto color : {Color::WHITE, Color::BLACK}) {
+        auto home_rank = (color == Color::WHITE) ? 0 : 7;
+        auto king_side = (color == Color::WHITE) ? WHITE_KING_SIDE : BLACK_KING_SIDE;
+        auto queen_side = (color == Color::WHITE) ? WHITE_QUEEN_SIDE : BLACK_QUEEN_SIDE;
+
+        // an unmoved king still stands on its start field, in chess960 that can be any file
+        for (int file = 0; file < 8; ++file) {
+            if (!unmoved(home_rank, file, 'K', color)) {
+                continue;
+            }
+
+            auto king_rook = castling_files[KING_SIDE];
+            auto queen_rook = castling_files[QUEEN_SIDE];
+            if (king_rook > file && unmoved(home_rank, king_rook, 'R', color)) rights |= king_side;
+            if (queen_rook < file && unmoved(home_rank, queen_rook, 'R', color)) rights |= queen_side;
+            break;
+        }
+    }
+
+    return rights;
+}
+
+/**
+ * Checks if a move of the king is castling, and where the king and the rook end up.
+ * Castling is written as the king moving two fields towards the rook,
+ * on a chess960 board as the king capturing its own rook.
+ * @param from The field the move starts on.
+ * @param to The field the move ends on.
+ * @param castling Set to the fields of the king and the rook, if the move is castling.
+ * @return true if the move is castling.
+ */
+bool GameBoard::get_castling_move(Position from, Position to, CastlingMove& castling) const {
+    auto king = get_piece(from);
+    if (!king || king->get_name() != 'K' || from.get_x() != to.get_x()) {
+        return false;
+    }
+
+    // the files of the king and the rook are mirrored on a flipped board
+    auto relative_file = [this](int file) {
+        return flipped ? 7 - file : file;
+    };
+
+    auto target = get_piece(to);
+    Position rook_from;
+
+    if (target) {
+        if (target->get_name() != 'R' || target->get_color() != king->get_color()) {
+            return false;
+        }
+        rook_from = to;
+    } else if (!chess960 && std::abs(to.get_y() - from.get_y()) == 2) {
+        auto side = ((to.get_y() > from.get_y()) != flipped) ? KING_SIDE : QUEEN_SIDE;
+        rook_from = Position(from.get_x(), relative_file(castling_files[side]));
+    } else {
+        return false;
+    }
+
+    castling.side = (absolute(rook_from).get_y() > absolute(from).get_y()) ? KING_SIDE : QUEEN_SIDE;
+    castling.king_from = from;
+    castling.king_to = Position(from.get_x(), relative_file(castling.side == KING_SIDE ? 6 : 2));
+    castling.rook_from = rook_from;
+    castling.rook_to = Position(from.get_x(), relative_file(castling.side == KING_SIDE ? 5 : 3));
+    return true;
+}
+
+/**
+ * Gets the column of the pawn that can be captured en passant.
+ * Only reported if a pawn of the player to move stands next to it.
+ * @param side_to_move The color of the player to move.
+ * @return The absolute column (0 = A) or -1 if there is no en passant capture.
+ */
+int GameBoard::get_en_passant_file(Color side_to_move) const {
+    if (last_move.get_name() != 'P') {
+        return -1;
+    }
+
+    auto from = last_move.get_from();
+    auto to = last_move.get_to();
+
+    if (!to.is_valid() || abs(to.get_x() - from.get_x()) != 2 || to.get_y() != from.get_y()) {
+        return -1;
+    }
+
+    for (int dy = -1; dy <= 1; dy += 2) {
+        auto neighbour = Position(to.get_x(), to.get_y() + dy);
+        if (!neighbour.is_valid()) {
+            continue;
+        }
+
+        auto piece = get_piece(neighbour);
+        if (piece && piece->get_name() == 'P' && piece->get_color() == side_to_move) {
+            return absolute(to).get_y();
+        }
+    }
+
+    return -1;
+}
+
 /**
  * Check if the game is over
  * @return private variable game_over
@@ -449,15 +568,69 @@ bool GameBoard::is_game_over(const Color current_player) {
     return !has_moves_left(enemy_color);
 }
 
-bool GameBoard::is_stalemate() {
-    // check if the king is in check
-    if (is_king_in_check(Color::WHITE) || is_king_in_check(Color::BLACK)) {
-        return false;
+/**
+ * Checks if the opponent of the player who just moved is stalemated.
+ * Only the player to move matters, a player without moves who is not to move is not stalemated.
+ * @param current_player The player who made the last move.
+ * @return true if the opponent is not in check and has no legal move.
+ */
+bool GameBoard::is_stalemate(const Color current_player) {
+    auto enemy_color = enemy_of(current_player);
+    return !is_king_in_check(enemy_color) && !has_moves_left(enemy_color);
+}
+
+/**
+ * Checks for a draw by threefold repetition, the fifty move rule or insufficient material.
+ * @param history The positions before the current one.
+ * @param side_to_move The color of the player to move.
+ * @return true if the game is drawn.
+ */
+bool GameBoard::is_draw(const PositionHistory& history, Color side_to_move) const {
+    if (halfmove_clock >= 100 || has_insufficient_material()) {
+        return true;
+    }
+
+    auto key = Zobrist::hash(*this, side_to_move);
+    return history.repetitions(key, halfmove_clock) >= 2;
+}
+
+/**
+ * Checks if neither player has enough pieces left to checkmate.
+ * This is the case for king against king with at most one knight or bishop,
+ * or when all bishops left stand on fields of the same color.
+ */
+bool GameBoard::has_insufficient_material() const {
+    int knights = 0;
+    int bishops = 0;
+    int bishop_field_colors = 0;
+
+    for (int i = 0; i < 8; ++i) {
+        for (int j = 0; j < 8; ++j) {
+            if (!board[i][j]) {
+                continue;
+            }
+
+            switch (board[i][j]->get_name()) {
+                case 'K':
+                    break;
+                case 'N':
+                    ++knights;
+                    break;
+                case 'B':
+                    ++bishops;
+                    bishop_field_colors |= 1 << ((i + j) % 2);
+                    break;
+                default:
+                    return false;
+            }
+        }
     }
 
-    auto is_stalemate = !has_moves_left(Color::WHITE) || !has_moves_left(Color::BLACK);
+    if (knights + bishops <= 1) {
+        return true;
+    }
 
-    return is_stalemate;
+    return knights == 0 && bishop_field_colors != 3;
 }
 
 /**
@@ -481,12 +654,40 @@ void GameBoard::flip() {
     //}
 
     flipped = !flipped;
+
+    // the position stays the same, so the safety of the kings is still known, only on the mirrored fields
+    for (auto& safety : king_safety) {
+        if (safety.king.is_valid()) {
+            safety.king = Position{7 - safety.king.get_x(), 7 - safety.king.get_y()};
+        }
+        safety.checkers = mirror_fields(safety.checkers);
+        safety.check_targets = mirror_fields(safety.check_targets);
+        safety.pinned = mirror_fields(safety.pinned);
+        safety.attacked = mirror_fields(safety.attacked);
+    }
 }
 
 // *****************************************************
 // Private Methods
 // *****************************************************
 
+/**
+ * Moves the king and the rook of a castling move, or back again.
+ * Both pieces are taken off the board first, as the king may land on the field of the rook or the other way around.
+ * The moved flags are left alone, the move generator undoes the move right away.
+ */
+void GameBoard::move_castling_pieces(const CastlingMove& castling, bool undo) {
+    auto king_from = undo ? castling.king_to : castling.king_from;
+    auto king_to = undo ? castling.king_from : castling.king_to;
+    auto rook_from = undo ? castling.rook_to : castling.rook_from;
+    auto rook_to = undo ? castling.rook_from : castling.rook_to;
+
+    auto king = std::move(board[king_from.get_x()][king_from.get_y()]);
+    auto rook = std::move(board[rook_from.get_x()][rook_from.get_y()]);
+    board[king_to.get_x()][king_to.get_y()] = std::move(king);
+    board[rook_to.get_x()][rook_to.get_y()] = std::move(rook);
+}
+
 void GameBoard::init_normal() {
     // create standard chess board
     board[7][0] = make_unique<Rook>(Color::BLACK);
@@ -560,81 +761,6 @@ void GameBoard::init_castling() {
     board[7][0] = make_unique<Rook>(Color::BLACK);
 }
 
-void GameBoard::clear_screen() {
-    std::cout << "\x1B[2J\x1B[H";
-}
-
-/**
- * Runs checks to figure out if the king is in check.
- * @param current_player
- * @param king_pos
- * @param diagonal_moves
- * @param straight_moves
- * @param knight_moves
- * @return true if the king is in check, false otherwise
- */
-bool GameBoard::king_in_check(Color current_player,
-                              const Position &king_pos,
-                              const VecPos& diagonal_moves,
-                              const VecPos& straight_moves,
-                              const VecPos& knight_moves) const
-{
-    if (diagonal_moves.empty() && straight_moves.empty() && knight_moves.empty()) {
-        return false;
-    }
-
-    // check if the king is in check by a diagonal attacker
-    for (auto & diagonal_move : diagonal_moves) {
-        auto piece = board[diagonal_move.get_x()][diagonal_move.get_y()].get();
-
-        if (
-                piece &&
-                piece->get_color() != current_player &&
-                (piece->get_name() == 'B' || piece->get_name() == 'Q' || piece->get_name() == 'P')
-                ) {
-            if (piece->get_name() == 'P') {
-                auto delta_x = diagonal_move.get_x() - king_pos.get_x();
-                auto delta_y = diagonal_move.get_y() - king_pos.get_y();
-
-                if (delta_x == 1 && abs(delta_y) == 1) {
-                    return true;
-                }
-
-            } else {
-                return true;
-            }
-        }
-    }
-
-    // check if the king is in check by a straight attacker
-    for (auto & straight_move : straight_moves) {
-        auto piece = board[straight_move.get_x()][straight_move.get_y()].get();
-
-        if (
-                piece &&
-                piece->get_color() != current_player &&
-                (piece->get_name() == 'R' || piece->get_name() == 'Q')
-                ) {
-            return true;
-        }
-    }
-
-    // check if the king is in check by a knight attacker
-    for (auto & knight_move : knight_moves) {
-        auto piece = board[knight_move.get_x()][knight_move.get_y()].get();
-
-        if (
-                piece &&
-                piece->get_color() != current_player &&
-                piece->get_name() == 'N'
-                ) {
-            return true;
-        }
-    }
-
-    return false;
-}
-
 /**
  * If the piece is a pawn, ask the player to which piece they want to promote it.
  * @param x
@@ -645,6 +771,7 @@ bool GameBoard::king_in_check(Color current_player,
 void GameBoard::do_possible_promotion(int& x, int& y, Color player_color) {
     if (x == 7 && board[x][y]->get_name() == 'P') {
         board[x][y].reset();
+        STATS_INC(ALLOCATIONS);
 
         auto promotion_piece = get_promotion_piece();
 
@@ -669,26 +796,13 @@ void GameBoard::do_possible_promotion(int& x, int& y, Color player_color) {
 
 /**
  * Check if there are any pieces of the given color that have valid moves.
+ * The answer is kept with the KingSafety of the position, so is_game_over and is_stalemate
+ * ask the move generator only once per position and player.
  * @param player_color
  * @return
  */
 bool GameBoard::has_moves_left(Color player_color) {
-    flip();
-    // check if there are any possible moves for the enemy
-    for (int i = 0; i < 8; ++i) {
-        for (int j = 0; j < 8; ++j) {
-            if (board[i][j] && board[i][j]->get_color() == player_color) {
-                auto pos = Position{i, j};
-                auto moves = get_valid_moves_for(pos);
+    STATS_TIMER(HAS_MOVES_LEFT);
 
-                if (!moves.empty()) {
-                    flip();
-                    return true;
-                }
-            }
-        }
-    }
-
-    flip();
-    return false;
-}
\ No newline at end of file
+    return MoveGen::has_legal_move(*this, player_color);
+}
@@ -3,6 +3,9 @@ class Gameboard;
 #include "../pieces/ChessPiece.hpp"
 #include "../color/Color.hpp"
 #include "../position/LastMove.hpp"
+#include "../position/Move.hpp"
+#include "../position/PositionHistory.hpp"
+#include <cstdint>
 #include <memory>
 #include <string>
 using std::make_unique;
@@ -14,15 +17,81 @@ enum class GameTest {
     PROMOTION,
     EN_PASSANT,
     CASTLING,
-    CHECK
+    CHECK,
+    EMPTY
+};
+
+// castling rights as bits, white at the bottom of the absolute board
+enum CastlingRight {
+    WHITE_KING_SIDE = 1,
+    WHITE_QUEEN_SIDE = 2,
+    BLACK_KING_SIDE = 4,
+    BLACK_QUEEN_SIDE = 8
+};
+
+// the sides a king can castle to, the king side is towards the h file
+enum CastlingSide {
+    QUEEN_SIDE = 0,
+    KING_SIDE = 1
+};
+
+// the fields of both pieces of a castling move, relative to the orientation of the board.
+// in chess960 the king may stay on its field or land on the field of its rook
+struct CastlingMove {
+    CastlingSide side{KING_SIDE};
+    Position king_from;
+    Position king_to;
+    Position rook_from;
+    Position rook_to;
+};
+
+// what the move generator knows about the safety of one king in a position.
+// it is computed the first time it is needed and kept by the gameboard until the position changes,
+// so the end of the game detection and the legality of the moves share it.
+// the fields are bits x * 8 + y, in the current orientation of the board
+struct KingSafety {
+    bool checks_known{false};
+    bool attacks_known{false};
+    bool moves_known{false};
+
+    Position king;
+    uint64_t checkers{0};
+    // the fields a piece other than the king has to move to: the checker and the fields between it and the king.
+    // every field if the king is not in check, none in a double check
+    uint64_t check_targets{~uint64_t{0}};
+
+    // the own pieces that are the only piece between the king and an enemy bishop, rook or queen
+    uint64_t pinned{0};
+    // the fields the opponent attacks, the bishops, rooks and queens look through the king,
+    // as it can not escape along the line it is attacked on
+    uint64_t attacked{0};
+
+    // if the player has a legal move, once moves_known is set
+    bool has_moves{false};
 };
 
 class GameBoard {
+    // the move generator of the engine temporarily moves pieces around
+    // to check if a move is legal, without copying the whole board
+    friend class MoveGen;
+    // positions read from text set up the board directly
+    friend class Fen;
+
     std::unique_ptr<ChessPiece> board[8][8];
     bool flipped{false};
     LastMove last_move{' ', Position(-1, -1), Position(-1, -1)};
     Position en_passant_target;
     VecPos castling_targets;
+    int halfmove_clock{0};
+
+    // the absolute files of the rooks that castle, by CastlingSide.
+    // a chess960 board castles with the king capturing its own rook, as the king may move only one field or none at all
+    int castling_files[2]{0, 7};
+    bool chess960{false};
+
+    // the safety of both kings by Color, filled in by the move generator and cleared by every move.
+    // a copy of the board starts without it, as it is made to play a move on it
+    mutable KingSafety king_safety[2];
 
     void init_normal();
     void init_check();
@@ -32,11 +101,13 @@ class GameBoard {
     void init_en_passant();
     void init_castling();
 
-    static void clear_screen();
+    void clear_king_safety() {
+        king_safety[0] = KingSafety{};
+        king_safety[1] = KingSafety{};
+    }
 
-    [[nodiscard]] bool king_in_check(Color current_player, const Position& king_pos, const VecPos& diagonal_moves, const VecPos& straight_moves, const VecPos& knight_moves) const;
     void do_possible_promotion(int& x, int& y, Color player_color);
-    bool has_moves_left(Color player_color);
+    void move_castling_pieces(const CastlingMove& castling, bool undo);
 public:
     GameBoard(GameTest option);
     GameBoard(const GameBoard& other);
@@ -54,9 +125,53 @@ public:
     static char get_promotion_piece();
 
     void move_piece(Position old_pos, Position new_pos, bool not_tmp);
+    void make_move(const Move& move);
+    void make_null_move();
 
     [[nodiscard]] bool is_game_over(Color current_player);
-    bool is_stalemate();
+    [[nodiscard]] bool is_stalemate(Color current_player);
+    bool has_moves_left(Color player_color);
+    [[nodiscard]] bool is_draw(const PositionHistory& history, Color side_to_move) const;
+    [[nodiscard]] bool has_insufficient_material() const;
+
+    [[nodiscard]] int get_halfmove_clock() const {
+        return halfmove_clock;
+    }
+
+    [[nodiscard]] ChessPiece* get_piece(Position position) const {
+        return board[position.get_x()][position.get_y()].get();
+    }
+
+    [[nodiscard]] const LastMove& get_last_move() const {
+        return last_move;
+    }
+
+    /**
+     * Converts a position between the current orientation of the board
+     * and the absolute orientation, where white is at the bottom.
+     * As flipping is its own inverse, this works in both directions.
+     */
+    [[nodiscard]] Position absolute(Position position) const {
+        if (!flipped) {
+            return position;
+        }
+        return {7 - position.get_x(), 7 - position.get_y()};
+    }
+
+    [[nodiscard]] int get_castling_rights() const;
+    [[nodiscard]] bool get_castling_move(Position from, Position to, CastlingMove& castling) const;
+
+    /**
+     * @return The absolute file of the rook that castles to the given side.
+     */
+    [[nodiscard]] int get_castling_file(CastlingSide side) const {
+        return castling_files[side];
+    }
+
+    [[nodiscard]] bool is_chess960() const {
+        return chess960;
+    }
+    [[nodiscard]] int get_en_passant_file(Color side_to_move) const;
 
     [[nodiscard]] bool is_flipped() const {
         return flipped;
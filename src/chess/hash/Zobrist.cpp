@@ -0,0 +1,79 @@
+#include "Zobrist.hpp"
+#include <array>
+
+namespace {
+    // 12 piece types * 64 fields, 16 castling combinations, 8 en passant columns and the side to move
+    constexpr int PIECE_KEYS = 12 * 64;
+    constexpr int CASTLING_OFFSET = PIECE_KEYS;
+    constexpr int EN_PASSANT_OFFSET = CASTLING_OFFSET + 16;
+    constexpr int SIDE_OFFSET = EN_PASSANT_OFFSET + 8;
+    constexpr int KEY_COUNT = SIDE_OFFSET + 1;
+
+    // the keys are created at compile time with splitmix64,
+    // so they are the same for every build and every run
+    constexpr std::array<uint64_t, KEY_COUNT> create_keys() {
+        std::array<uint64_t, KEY_COUNT> keys{};
+        uint64_t state = 0x2545F4914F6CDD1DULL;
+
+        for (auto& key : keys) {
+            state += 0x9E3779B97F4A7C15ULL;
+            auto z = state;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            key = z ^ (z >> 31);
+        }
+
+        return keys;
+    }
+
+    constexpr auto KEYS = create_keys();
+}
+
+/**
+ * Creates the hash of the board from scratch.
+ * The hash uses absolute positions, so it does not depend on the orientation of the board.
+ * @param board The gameboard.
+ * @param side_to_move The color of the player to move.
+ * @return The 64 bit hash of the position.
+ */
+uint64_t Zobrist::hash(const GameBoard& board, Color side_to_move) {
+    uint64_t key = 0;
+
+    for (int x = 0; x < 8; ++x) {
+        for (int y = 0; y < 8; ++y) {
+            auto position = Position(x, y);
+            auto piece = board.get_piece(position);
+
+            if (piece) {
+                key ^= piece_key(piece->get_name(), piece->get_color(), board.absolute(position));
+            }
+        }
+    }
+
+    key ^= castling_key(board.get_castling_rights());
+    key ^= en_passant_key(board.get_en_passant_file(side_to_move));
+
+    if (side_to_move == Color::BLACK) {
+        key ^= side_key();
+    }
+
+    return key;
+}
+
+uint64_t Zobrist::piece_key(char name, Color color, Position absolute_position) {
+    auto piece = ChessPiece::get_type_index(name) + (color == Color::BLACK ? 6 : 0);
+    auto square = absolute_position.get_x() * 8 + absolute_position.get_y();
+    return KEYS[static_cast<size_t>(piece * 64 + square)];
+}
+
+uint64_t Zobrist::castling_key(int castling_rights) {
+    return castling_rights ? KEYS[static_cast<size_t>(CASTLING_OFFSET + castling_rights)] : 0;
+}
+
+uint64_t Zobrist::en_passant_key(int file) {
+    return (file >= 0) ? KEYS[static_cast<size_t>(EN_PASSANT_OFFSET + file)] : 0;
+}
+
+uint64_t Zobrist::side_key() {
+    return KEYS[SIDE_OFFSET];
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <cstdint>
+#include "../gameboard/GameBoard.hpp"
+#include "../color/Color.hpp"
+
+// zobrist hashing of a gameboard
+// every piece on every field, the castling rights, the en passant column and the player to move
+// get a random 64 bit key, the hash of a position is the xor of all its keys
+class Zobrist {
+public:
+    [[nodiscard]] static uint64_t hash(const GameBoard& board, Color side_to_move);
+
+    [[nodiscard]] static uint64_t piece_key(char name, Color color, Position absolute_position);
+    [[nodiscard]] static uint64_t castling_key(int castling_rights);
+    [[nodiscard]] static uint64_t en_passant_key(int file);
+    [[nodiscard]] static uint64_t side_key();
+};
@@ -0,0 +1,972 @@
+#include "MoveGen.hpp"
+#include <algorithm>
+#include "../stats/Stats.hpp"
+
+namespace {
+    constexpr int KNIGHT_DELTAS[8][2] = {{2, 1}, {2, -1}, {-2, 1}, {-2, -1}, {1, 2}, {1, -2}, {-1, 2}, {-1, -2}};
+    constexpr int KING_DELTAS[8][2] = {{1, 1}, {1, 0}, {1, -1}, {0, 1}, {0, -1}, {-1, 1}, {-1, 0}, {-1, -1}};
+    constexpr int DIAGONALS[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+    constexpr int STRAIGHTS[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+    constexpr char PROMOTIONS[4] = {'Q', 'R', 'B', 'N'};
+
+    bool on_board(int x, int y) {
+        return x >= 0 && x < 8 && y >= 0 && y < 8;
+    }
+
+    // the bit of a field in the target fields of a generator
+    uint64_t field_bit(int x, int y) {
+        return uint64_t{1} << (x * 8 + y);
+    }
+
+    constexpr uint64_t ALL_FIELDS = ~uint64_t{0};
+
+    /**
+     * @param capture If the move captures, or is a push promoting to a queen.
+     * @return true if the generator of the given type creates the move.
+     */
+    template<GenType Type>
+    constexpr bool creates(bool capture) {
+        return (Type != GenType::CAPTURES || capture) && (Type != GenType::QUIETS || !capture);
+    }
+}
+
+// *****************************************************
+// Public Methods
+// *****************************************************
+
+/**
+ * Generates the moves of the given player, without checking if the own king is left in check.
+ * Castling is only generated if the king is not in check and does not pass an attacked field.
+ * @param board The gameboard.
+ * @param us The color of the player to move.
+ * @param moves The list the moves are appended to.
+ * @param type The kind of moves, EVASIONS only for a king in check.
+ */
+void MoveGen::generate_pseudo_legal(const GameBoard& board, Color us, MoveList& moves, GenType type) {
+    if (us == Color::WHITE) {
+        generate_type<Color::WHITE>(board, type, moves);
+    } else {
+        generate_type<Color::BLACK>(board, type, moves);
+    }
+}
+
+/**
+ * Generates the legal moves of the given player.
+ * @param board The gameboard, it is unchanged after the call.
+ * @param us The color of the player to move.
+ * @param moves The list the moves are appended to.
+ * @param type The kind of moves, EVASIONS only for a king in check.
+ */
+void MoveGen::generate_legal(GameBoard& board, Color us, MoveList& moves, GenType type) {
+    if (us == Color::WHITE) {
+        legal_moves<Color::WHITE>(board, type, moves);
+    } else {
+        legal_moves<Color::BLACK>(board, type, moves);
+    }
+}
+
+/**
+ * Generates the legal castling moves of the king, used when a player chooses the king.
+ * @param board The gameboard, it is unchanged after the call.
+ * @param king_pos The position of the king.
+ * @param us The color of the player to move.
+ * @param moves The list the moves are appended to.
+ */
+void MoveGen::generate_castling(GameBoard& board, Position king_pos, Color us, MoveList& moves) {
+    MoveList pseudo_legal;
+    if (us == Color::WHITE) {
+        add_castling_moves<Color::WHITE>(board, king_pos, pseudo_legal);
+    } else {
+        add_castling_moves<Color::BLACK>(board, king_pos, pseudo_legal);
+    }
+
+    for (const auto& move : pseudo_legal) {
+        if (is_legal(board, us, move, king_pos)) {
+            moves.push_back(move);
+        }
+    }
+}
+
+/**
+ * Checks if a pseudo legal move leaves the own king in check.
+ * The pieces are moved on the board itself and moved back afterwards,
+ * so no copy of the board is needed.
+ * @param board The gameboard, it is unchanged after the call.
+ * @param us The color of the player to move.
+ * @param move The pseudo legal move.
+ * @param king_pos The position of the king of the player to move.
+ * @return true if the king is not in check after the move.
+ */
+bool MoveGen::is_legal(GameBoard& board, Color us, const Move& move, Position king_pos) {
+    return (us == Color::WHITE) ? is_legal<Color::WHITE>(board, move, king_pos)
+                                : is_legal<Color::BLACK>(board, move, king_pos);
+}
+
+/**
+ * Checks if the given player has at least one legal move.
+ * Stops at the first legal move found, the answer is kept with the KingSafety of the position.
+ */
+bool MoveGen::has_legal_move(GameBoard& board, Color us) {
+    auto white = us == Color::WHITE;
+    auto& safety = white ? find_attacks<Color::WHITE>(board) : find_attacks<Color::BLACK>(board);
+
+    if (!safety.moves_known) {
+        MoveList pseudo_legal;
+        generate_pseudo_legal(board, us, pseudo_legal, safety.checkers ? GenType::EVASIONS : GenType::ALL);
+
+        safety.has_moves = std::any_of(pseudo_legal.begin(), pseudo_legal.end(), [&](const Move& move) {
+            return white ? is_legal<Color::WHITE>(board, move, safety) : is_legal<Color::BLACK>(board, move, safety);
+        });
+        safety.moves_known = true;
+    }
+
+    return safety.has_moves;
+}
+
+/**
+ * Checks if the field is attacked by any piece of the given color.
+ * @param board The gameboard.
+ * @param square The attacked field.
+ * @param by The color of the attacking player.
+ */
+bool MoveGen::is_square_attacked(const GameBoard& board, Position square, Color by) {
+    return (by == Color::WHITE) ? is_square_attacked<Color::WHITE>(board, square)
+                                : is_square_attacked<Color::BLACK>(board, square);
+}
+
+/**
+ * Checks if the king of the given color is in check, in both orientations of the board.
+ */
+bool MoveGen::in_check(const GameBoard& board, Color color) {
+    return king_safety(board, color).checkers != 0;
+}
+
+/**
+ * Gets the position and the checks of the king of the given color.
+ * They are computed once per position, the gameboard keeps them until the next move.
+ * The pins and the attacked fields are only filled in by the generation of the legal moves.
+ * @return The KingSafety kept by the gameboard, with an invalid king if there is none.
+ */
+const KingSafety& MoveGen::king_safety(const GameBoard& board, Color color) {
+    return (color == Color::WHITE) ? find_checks<Color::WHITE>(board) : find_checks<Color::BLACK>(board);
+}
+
+/**
+ * Finds the king of the given color.
+ * @return The position of the king, or an invalid position if there is no king.
+ */
+Position MoveGen::find_king(const GameBoard& board, Color color) {
+    for (int x = 0; x < 8; ++x) {
+        for (int y = 0; y < 8; ++y) {
+            auto piece = board.board[x][y].get();
+            if (piece && piece->get_name() == 'K' && piece->get_color() == color) {
+                return {x, y};
+            }
+        }
+    }
+
+    return {};
+}
+
+/**
+ * Checks if the move captures a piece, including en passant.
+ */
+bool MoveGen::is_capture(const GameBoard& board, const Move& move) {
+    auto from = move.get_from();
+    auto to = move.get_to();
+    auto piece = board.board[from.get_x()][from.get_y()].get();
+    auto target = board.board[to.get_x()][to.get_y()].get();
+
+    // a chess960 king castles by moving onto its own rook
+    if (target) {
+        return !piece || target->get_color() != piece->get_color();
+    }
+
+    return piece && piece->get_name() == 'P' && from.get_y() != to.get_y();
+}
+
+/**
+ * Checks if a legal move gives check or checkmate.
+ * Like is_legal the move is made on the board itself and undone afterwards,
+ * only a promotion creates a new piece.
+ * @param board The gameboard, it is unchanged after the call.
+ * @param us The color of the player making the move.
+ * @param move The legal move.
+ * @return If the opponent is in check after the move, and if it has a legal move left.
+ */
+CheckState MoveGen::check_state_after(GameBoard& board, Color us, const Move& move) {
+    auto enemy = enemy_of(us);
+
+    // the KingSafety of the position after the move is thrown away with the move,
+    // the one of the current position is still valid when the move is undone
+    KingSafety king_safety[2] = {board.king_safety[0], board.king_safety[1]};
+    auto state_of_enemy = [&board, enemy]() {
+        board.clear_king_safety();
+        if (!in_check(board, enemy)) {
+            return CheckState::NONE;
+        }
+        return has_legal_move(board, enemy) ? CheckState::CHECK : CheckState::CHECKMATE;
+    };
+
+    auto last_move = board.last_move;
+
+    CastlingMove castling;
+    if (board.get_castling_move(move.get_from(), move.get_to(), castling)) {
+        board.move_castling_pieces(castling, false);
+        board.last_move = LastMove{'K', move.get_from(), move.get_to()};
+
+        auto state = state_of_enemy();
+
+        board.last_move = last_move;
+        board.move_castling_pieces(castling, true);
+        std::copy(std::begin(king_safety), std::end(king_safety), board.king_safety);
+        return state;
+    }
+
+    auto fx = move.get_from().get_x();
+    auto fy = move.get_from().get_y();
+    auto tx = move.get_to().get_x();
+    auto ty = move.get_to().get_y();
+
+    auto moving = std::move(board.board[fx][fy]);
+    auto captured = std::move(board.board[tx][ty]);
+    auto name = moving->get_name();
+    std::unique_ptr<ChessPiece> en_passant_captured;
+
+    auto en_passant = name == 'P' && fy != ty && !captured;
+    if (en_passant) {
+        en_passant_captured = std::move(board.board[fx][ty]);
+    }
+
+    board.board[tx][ty] = std::move(moving);
+
+    std::unique_ptr<ChessPiece> pawn;
+    if (move.get_promotion() != ' ') {
+        pawn = std::move(board.board[tx][ty]);
+        switch (move.get_promotion()) {
+            case 'R': board.board[tx][ty] = make_unique<Rook>(us); break;
+            case 'B': board.board[tx][ty] = make_unique<Bishop>(us); break;
+            case 'N': board.board[tx][ty] = make_unique<Knight>(us); break;
+            default: board.board[tx][ty] = make_unique<Queen>(us); break;
+        }
+    }
+
+    // a double step of a pawn allows the opponent to capture en passant
+    board.last_move = LastMove{name, move.get_from(), move.get_to()};
+
+    auto state = state_of_enemy();
+
+    // undo the move
+    board.last_move = last_move;
+    if (pawn) {
+        board.board[tx][ty] = std::move(pawn);
+    }
+    board.board[fx][fy] = std::move(board.board[tx][ty]);
+    board.board[tx][ty] = std::move(captured);
+    if (en_passant) {
+        board.board[fx][ty] = std::move(en_passant_captured);
+    }
+    std::copy(std::begin(king_safety), std::end(king_safety), board.king_safety);
+
+    return state;
+}
+
+// *****************************************************
+// Private Methods
+// *****************************************************
+
+/**
+ * Gets the direction in which the pawns of the given color move.
+ * White moves up if the board is not flipped.
+ * @return 1 if the pawns move up the board, -1 otherwise.
+ */
+template<Color Us>
+int MoveGen::pawn_direction(const GameBoard& board) {
+    return ((Us == Color::WHITE) != board.flipped) ? 1 : -1;
+}
+
+/**
+ * Chooses the generator of the kind of moves.
+ */
+template<Color Us>
+void MoveGen::generate_type(const GameBoard& board, GenType type, MoveList& moves) {
+    switch (type) {
+        case GenType::CAPTURES:
+            generate_moves<Us, GenType::CAPTURES>(board, moves);
+            break;
+        case GenType::QUIETS:
+            generate_moves<Us, GenType::QUIETS>(board, moves);
+            break;
+        case GenType::EVASIONS:
+            generate_moves<Us, GenType::EVASIONS>(board, moves);
+            break;
+        default:
+            generate_moves<Us, GenType::ALL>(board, moves);
+            break;
+    }
+}
+
+template<Color Us, GenType Type>
+void MoveGen::generate_moves(const GameBoard& board, MoveList& moves) {
+    STATS_TIMER(MOVE_GENERATION);
+
+    // in check the pieces other than the king may only move to the fields that end the check
+    auto targets = ALL_FIELDS;
+    if constexpr (Type == GenType::EVASIONS) {
+        targets = find_checks<Us>(board).check_targets;
+    }
+
+    for (int x = 0; x < 8; ++x) {
+        for (int y = 0; y < 8; ++y) {
+            auto piece = board.board[x][y].get();
+
+            if (!piece || piece->get_color() != Us) {
+                continue;
+            }
+
+            auto position = Position(x, y);
+
+            switch (piece->get_name()) {
+                case 'P':
+                    add_pawn_moves<Us, Type>(board, position, targets, moves);
+                    break;
+                case 'N':
+                    add_step_moves<Us, Type>(board, position, KNIGHT_DELTAS, targets, moves);
+                    break;
+                case 'B':
+                    add_slider_moves<Us, Type>(board, position, DIAGONALS, targets, moves);
+                    break;
+                case 'R':
+                    add_slider_moves<Us, Type>(board, position, STRAIGHTS, targets, moves);
+                    break;
+                case 'Q':
+                    add_slider_moves<Us, Type>(board, position, DIAGONALS, targets, moves);
+                    add_slider_moves<Us, Type>(board, position, STRAIGHTS, targets, moves);
+                    break;
+                case 'K':
+                    // the king escapes to any field, is_legal checks if it is still attacked there
+                    add_step_moves<Us, Type>(board, position, KING_DELTAS, ALL_FIELDS, moves);
+                    if constexpr (Type == GenType::ALL || Type == GenType::QUIETS) {
+                        add_castling_moves<Us>(board, position, moves);
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    add_en_passant_moves<Us, Type>(board, targets, moves);
+}
+
+template<Color Us>
+void MoveGen::legal_moves(GameBoard& board, GenType type, MoveList& moves) {
+    auto& safety = find_attacks<Us>(board);
+
+    MoveList pseudo_legal;
+    generate_type<Us>(board, type, pseudo_legal);
+
+    auto count = moves.size();
+    for (const auto& move : pseudo_legal) {
+        if (is_legal<Us>(board, move, safety)) {
+            moves.push_back(move);
+        }
+    }
+
+    // every move of the player was generated, so it is known if there is one left
+    if (type == GenType::ALL || (type == GenType::EVASIONS && safety.checkers)) {
+        safety.has_moves = moves.size() > count;
+        safety.moves_known = true;
+    }
+}
+
+/**
+ * Finds the king and the pieces giving check, unless they are already known in this position.
+ * A checking slider can also be blocked on every field of its ray, which are the check_targets.
+ */
+template<Color Us>
+KingSafety& MoveGen::find_checks(const GameBoard& board) {
+    auto& safety = board.king_safety[static_cast<int>(Us)];
+    if (safety.checks_known) {
+        return safety;
+    }
+
+    STATS_TIMER(CHECK_DETECTION);
+    safety.checks_known = true;
+    safety.king = find_king(board, Us);
+
+    if (!safety.king.is_valid()) {
+        return safety;
+    }
+
+    constexpr auto them = enemy_of(Us);
+    auto kx = safety.king.get_x();
+    auto ky = safety.king.get_y();
+    uint64_t checkers = 0;
+    uint64_t targets = 0;
+    auto count = 0;
+
+    auto is_checker = [&](int x, int y, char name, char other) {
+        auto piece = board.board[x][y].get();
+        if (!piece || piece->get_color() != them) {
+            return false;
+        }
+        auto piece_name = piece->get_name();
+        return piece_name == name || piece_name == other;
+    };
+
+    auto add_checker = [&](int x, int y, uint64_t blocks) {
+        checkers |= field_bit(x, y);
+        targets |= blocks;
+        ++count;
+    };
+
+    auto pawn_x = kx - pawn_direction<them>(board);
+    for (int dy = -1; dy <= 1; dy += 2) {
+        if (on_board(pawn_x, ky + dy) && is_checker(pawn_x, ky + dy, 'P', 'P')) {
+            add_checker(pawn_x, ky + dy, field_bit(pawn_x, ky + dy));
+        }
+    }
+
+    for (const auto& delta : KNIGHT_DELTAS) {
+        auto x = kx + delta[0];
+        auto y = ky + delta[1];
+        if (on_board(x, y) && is_checker(x, y, 'N', 'N')) {
+            add_checker(x, y, field_bit(x, y));
+        }
+    }
+
+    // kings can not give check, but GameBoard::validate_moves tries a king move next to the enemy king
+    for (const auto& delta : KING_DELTAS) {
+        auto x = kx + delta[0];
+        auto y = ky + delta[1];
+        if (on_board(x, y) && is_checker(x, y, 'K', 'K')) {
+            add_checker(x, y, field_bit(x, y));
+        }
+    }
+
+    auto slider_checks = [&](const int (&directions)[4][2], char name) {
+        for (const auto& direction : directions) {
+            uint64_t ray = 0;
+            auto x = kx + direction[0];
+            auto y = ky + direction[1];
+
+            while (on_board(x, y)) {
+                ray |= field_bit(x, y);
+                if (board.board[x][y]) {
+                    if (is_checker(x, y, name, 'Q')) {
+                        add_checker(x, y, ray);
+                    }
+                    break;
+                }
+                x += direction[0];
+                y += direction[1];
+            }
+        }
+    };
+
+    slider_checks(DIAGONALS, 'B');
+    slider_checks(STRAIGHTS, 'R');
+
+    safety.checkers = checkers;
+    if (count > 0) {
+        safety.check_targets = (count == 1) ? targets : 0;
+    }
+
+    return safety;
+}
+
+/**
+ * Finds the pinned pieces and the fields attacked by the opponent, unless they are already known in this position.
+ */
+template<Color Us>
+KingSafety& MoveGen::find_attacks(const GameBoard& board) {
+    auto& safety = find_checks<Us>(board);
+    if (safety.attacks_known) {
+        return safety;
+    }
+
+    STATS_TIMER(CHECK_DETECTION);
+    safety.attacks_known = true;
+
+    if (!safety.king.is_valid()) {
+        return safety;
+    }
+
+    constexpr auto them = enemy_of(Us);
+    auto kx = safety.king.get_x();
+    auto ky = safety.king.get_y();
+
+    // an own piece is pinned if the next piece behind it on the line from the king is an enemy slider
+    auto find_pins = [&](const int (&directions)[4][2], char name) {
+        for (const auto& direction : directions) {
+            uint64_t own = 0;
+            auto x = kx + direction[0];
+            auto y = ky + direction[1];
+
+            while (on_board(x, y)) {
+                auto piece = board.board[x][y].get();
+                if (piece) {
+                    if (piece->get_color() == Us && !own) {
+                        own = field_bit(x, y);
+                    } else {
+                        auto piece_name = piece->get_name();
+                        if (own && piece->get_color() == them && (piece_name == name || piece_name == 'Q')) {
+                            safety.pinned |= own;
+                        }
+                        break;
+                    }
+                }
+                x += direction[0];
+                y += direction[1];
+            }
+        }
+    };
+
+    find_pins(DIAGONALS, 'B');
+    find_pins(STRAIGHTS, 'R');
+
+    uint64_t attacked = 0;
+
+    auto step_attacks = [&](int px, int py, const int (&deltas)[8][2]) {
+        for (const auto& delta : deltas) {
+            auto x = px + delta[0];
+            auto y = py + delta[1];
+            if (on_board(x, y)) {
+                attacked |= field_bit(x, y);
+            }
+        }
+    };
+
+    auto slider_attacks = [&](int px, int py, const int (&directions)[4][2]) {
+        for (const auto& direction : directions) {
+            auto x = px + direction[0];
+            auto y = py + direction[1];
+
+            while (on_board(x, y)) {
+                attacked |= field_bit(x, y);
+                if (board.board[x][y] && (x != kx || y != ky)) {
+                    break;
+                }
+                x += direction[0];
+                y += direction[1];
+            }
+        }
+    };
+
+    auto pawn_step = pawn_direction<them>(board);
+
+    for (int x = 0; x < 8; ++x) {
+        for (int y = 0; y < 8; ++y) {
+            auto piece = board.board[x][y].get();
+            if (!piece || piece->get_color() != them) {
+                continue;
+            }
+
+            switch (piece->get_name()) {
+                case 'P':
+                    for (int dy = -1; dy <= 1; dy += 2) {
+                        if (on_board(x + pawn_step, y + dy)) {
+                            attacked |= field_bit(x + pawn_step, y + dy);
+                        }
+                    }
+                    break;
+                case 'N':
+                    step_attacks(x, y, KNIGHT_DELTAS);
+                    break;
+                case 'K':
+                    step_attacks(x, y, KING_DELTAS);
+                    break;
+                case 'B':
+                    slider_attacks(x, y, DIAGONALS);
+                    break;
+                case 'R':
+                    slider_attacks(x, y, STRAIGHTS);
+                    break;
+                case 'Q':
+                    slider_attacks(x, y, DIAGONALS);
+                    slider_attacks(x, y, STRAIGHTS);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    safety.attacked = attacked;
+    return safety;
+}
+
+template<Color Us, GenType Type>
+void MoveGen::add_pawn_moves(const GameBoard& board, Position position, uint64_t targets, MoveList& moves) {
+    auto px = position.get_x();
+    auto py = position.get_y();
+    auto direction = pawn_direction<Us>(board);
+    auto start_row = (direction == 1) ? 1 : 6;
+    auto last_row = (direction == 1) ? 7 : 0;
+
+    // a promotion to a queen is generated with the captures, the other promotions of a push with the quiet moves
+    auto add = [&](int x, int y, bool capture) {
+        if (!(targets & field_bit(x, y))) {
+            return;
+        }
+
+        auto to = Position(x, y);
+        if (x != last_row) {
+            if (creates<Type>(capture)) {
+                moves.push_back(Move(position, to));
+            }
+            return;
+        }
+
+        for (auto promotion : PROMOTIONS) {
+            if (creates<Type>(capture || promotion == 'Q')) {
+                moves.push_back(Move(position, to, promotion));
+            }
+        }
+    };
+
+    auto x = px + direction;
+    if (!on_board(x, py)) {
+        return;
+    }
+
+    // one step forward and two steps forward from the start row
+    if (!board.board[x][py]) {
+        add(x, py, false);
+
+        auto double_x = x + direction;
+        if (px == start_row && !board.board[double_x][py]) {
+            add(double_x, py, false);
+        }
+    }
+
+    // captures to the left and to the right
+    if constexpr (Type != GenType::QUIETS) {
+        for (int dy = -1; dy <= 1; dy += 2) {
+            auto y = py + dy;
+            if (!on_board(x, y)) {
+                continue;
+            }
+
+            auto target = board.board[x][y].get();
+            if (target && target->get_color() != Us) {
+                add(x, y, true);
+            }
+        }
+    }
+}
+
+/**
+ * Adds the en passant captures, if the last move was a double step of an enemy pawn.
+ * In check the capture has to take the checking pawn or block the check with the capturing pawn.
+ */
+template<Color Us, GenType Type>
+void MoveGen::add_en_passant_moves(const GameBoard& board, uint64_t targets, MoveList& moves) {
+    if constexpr (Type == GenType::QUIETS) {
+        return;
+    }
+
+    const auto& last_move = board.last_move;
+
+    if (last_move.get_name() != 'P') {
+        return;
+    }
+
+    auto from = last_move.get_from();
+    auto to = last_move.get_to();
+
+    if (!to.is_valid() || abs(to.get_x() - from.get_x()) != 2 || to.get_y() != from.get_y()) {
+        return;
+    }
+
+    auto enemy_pawn = board.board[to.get_x()][to.get_y()].get();
+    if (!enemy_pawn || enemy_pawn->get_name() != 'P' || enemy_pawn->get_color() == Us) {
+        return;
+    }
+
+    auto target = Position(to.get_x() + pawn_direction<Us>(board), to.get_y());
+    if (board.board[target.get_x()][target.get_y()]) {
+        return;
+    }
+
+    if (!(targets & (field_bit(to.get_x(), to.get_y()) | field_bit(target.get_x(), target.get_y())))) {
+        return;
+    }
+
+    for (int dy = -1; dy <= 1; dy += 2) {
+        auto y = to.get_y() + dy;
+        if (!on_board(to.get_x(), y)) {
+            continue;
+        }
+
+        auto piece = board.board[to.get_x()][y].get();
+        if (piece && piece->get_name() == 'P' && piece->get_color() == Us) {
+            moves.push_back(Move(Position(to.get_x(), y), target));
+        }
+    }
+}
+
+template<Color Us, GenType Type>
+void MoveGen::add_step_moves(const GameBoard& board, Position position, const int (&deltas)[8][2], uint64_t targets, MoveList& moves) {
+    for (const auto& delta : deltas) {
+        auto x = position.get_x() + delta[0];
+        auto y = position.get_y() + delta[1];
+
+        if (!on_board(x, y) || !(targets & field_bit(x, y))) {
+            continue;
+        }
+
+        auto target = board.board[x][y].get();
+        if (target ? (target->get_color() != Us && creates<Type>(true)) : creates<Type>(false)) {
+            moves.push_back(Move(position, Position(x, y)));
+        }
+    }
+}
+
+template<Color Us, GenType Type>
+void MoveGen::add_slider_moves(const GameBoard& board, Position position, const int (&directions)[4][2], uint64_t targets, MoveList& moves) {
+    for (const auto& direction : directions) {
+        auto x = position.get_x() + direction[0];
+        auto y = position.get_y() + direction[1];
+
+        while (on_board(x, y)) {
+            auto target = board.board[x][y].get();
+            auto wanted = (targets & field_bit(x, y)) != 0;
+
+            if (target) {
+                if (wanted && target->get_color() != Us && creates<Type>(true)) {
+                    moves.push_back(Move(position, Position(x, y)));
+                }
+                break;
+            }
+
+            if (wanted && creates<Type>(false)) {
+                moves.push_back(Move(position, Position(x, y)));
+            }
+            x += direction[0];
+            y += direction[1];
+        }
+    }
+}
+
+/**
+ * Adds the castling moves of the king.
+ * The rooks stand on the files of GameBoard::get_castling_file, the king ends on the g or c file
+ * and the rook next to it on the f or d file, see GameBoard::get_castling_move.
+ * All fields both pieces cross have to be empty, apart from the king and the rook themselves,
+ * and the king may not start in check or pass an attacked field. Its target field is checked by is_legal.
+ */
+template<Color Us>
+void MoveGen::add_castling_moves(const GameBoard& board, Position king_pos, MoveList& moves) {
+    constexpr auto enemy = enemy_of(Us);
+    auto home_row = (pawn_direction<Us>(board) == 1) ? 0 : 7;
+    auto x = king_pos.get_x();
+    auto y = king_pos.get_y();
+
+    if (x != home_row) {
+        return;
+    }
+
+    auto king = dynamic_cast<King*>(board.board[x][y].get());
+    if (!king || king->has_moved()) {
+        return;
+    }
+
+    if (is_square_attacked<enemy>(board, king_pos)) {
+        return;
+    }
+
+    // the files of the absolute board are mirrored on a flipped board
+    auto relative_file = [&board](int file) {
+        return board.flipped ? 7 - file : file;
+    };
+
+    for (auto side : {QUEEN_SIDE, KING_SIDE}) {
+        auto rook_y = relative_file(board.castling_files[side]);
+        auto piece = board.board[x][rook_y].get();
+        if (rook_y == y || !piece || piece->get_name() != 'R' || piece->get_color() != Us) {
+            continue;
+        }
+
+        auto rook = dynamic_cast<Rook*>(piece);
+        if (rook->has_moved()) {
+            continue;
+        }
+
+        auto king_to = relative_file(side == KING_SIDE ? 6 : 2);
+        auto rook_to = relative_file(side == KING_SIDE ? 5 : 3);
+
+        // the rook has to stand on the side of the king it castles to
+        if ((side == KING_SIDE) != ((rook_y > y) != board.flipped)) {
+            continue;
+        }
+
+        auto empty = true;
+        for (auto between = std::min({y, rook_y, king_to, rook_to}); between <= std::max({y, rook_y, king_to, rook_to}); ++between) {
+            if (between != y && between != rook_y && board.board[x][between]) {
+                empty = false;
+                break;
+            }
+        }
+
+        auto step = (king_to > y) ? 1 : -1;
+        for (auto passed = y + step; empty && king_to != y && passed != king_to; passed += step) {
+            empty = !is_square_attacked<enemy>(board, Position(x, passed));
+        }
+
+        if (!empty) {
+            continue;
+        }
+
+        // a chess960 king may move a single field or not at all, so it captures its own rook instead
+        auto target = board.chess960 ? Position(x, rook_y) : Position(x, king_to);
+        moves.push_back(Move(king_pos, target));
+    }
+}
+
+template<Color Us>
+bool MoveGen::is_legal(GameBoard& board, const Move& move, Position king_pos) {
+    STATS_TIMER(LEGALITY);
+    STATS_INC(LEGAL_CHECKS);
+
+    constexpr auto enemy = enemy_of(Us);
+
+    // the king of a castling move must not be in check on its new field, with the rook next to it
+    CastlingMove castling;
+    if (board.get_castling_move(move.get_from(), move.get_to(), castling)) {
+        board.move_castling_pieces(castling, false);
+        auto legal = !is_square_attacked<enemy>(board, castling.king_to);
+        board.move_castling_pieces(castling, true);
+        return legal;
+    }
+
+    auto fx = move.get_from().get_x();
+    auto fy = move.get_from().get_y();
+    auto tx = move.get_to().get_x();
+    auto ty = move.get_to().get_y();
+
+    auto moving = std::move(board.board[fx][fy]);
+    auto captured = std::move(board.board[tx][ty]);
+    std::unique_ptr<ChessPiece> en_passant_captured;
+
+    // a pawn moving diagonally onto an empty field captures the pawn next to it
+    auto en_passant = moving->get_name() == 'P' && fy != ty && !captured;
+    if (en_passant) {
+        en_passant_captured = std::move(board.board[fx][ty]);
+    }
+
+    if (moving->get_name() == 'K') {
+        king_pos = move.get_to();
+    }
+
+    board.board[tx][ty] = std::move(moving);
+
+    auto legal = king_pos.is_valid() && !is_square_attacked<enemy>(board, king_pos);
+
+    // undo the move
+    board.board[fx][fy] = std::move(board.board[tx][ty]);
+    board.board[tx][ty] = std::move(captured);
+    if (en_passant) {
+        board.board[fx][ty] = std::move(en_passant_captured);
+    }
+
+    return legal;
+}
+
+/**
+ * Checks if a pseudo legal move leaves the own king in check, with the KingSafety of the position.
+ * A king may not move to an attacked field, and other pieces have to end a check.
+ * Only pinned pieces, en passant and castling, which move more than one piece, are still moved on the board.
+ */
+template<Color Us>
+bool MoveGen::is_legal(GameBoard& board, const Move& move, const KingSafety& safety) {
+    if (!safety.king.is_valid()) {
+        return false;
+    }
+
+    auto from = move.get_from();
+    auto to = move.get_to();
+
+    if (from == safety.king) {
+        CastlingMove castling;
+        if (board.get_castling_move(from, to, castling)) {
+            return is_legal<Us>(board, move, safety.king);
+        }
+
+        STATS_INC(LEGAL_CHECKS);
+        return !(safety.attacked & field_bit(to.get_x(), to.get_y()));
+    }
+
+    auto moving = board.board[from.get_x()][from.get_y()].get();
+    auto en_passant = moving->get_name() == 'P' && from.get_y() != to.get_y() && !board.board[to.get_x()][to.get_y()];
+
+    if (en_passant || (safety.pinned & field_bit(from.get_x(), from.get_y()))) {
+        return is_legal<Us>(board, move, safety.king);
+    }
+
+    STATS_INC(LEGAL_CHECKS);
+    return (safety.check_targets & field_bit(to.get_x(), to.get_y())) != 0;
+}
+
+template<Color By>
+bool MoveGen::is_square_attacked(const GameBoard& board, Position square) {
+    auto sx = square.get_x();
+    auto sy = square.get_y();
+
+    auto is_attacker = [&](int x, int y, char name, char other) {
+        auto piece = board.board[x][y].get();
+        if (!piece || piece->get_color() != By) {
+            return false;
+        }
+        auto piece_name = piece->get_name();
+        return piece_name == name || piece_name == other;
+    };
+
+    // pawns capture diagonally in their moving direction,
+    // so an attacking pawn stands one row behind the field
+    auto pawn_x = sx - pawn_direction<By>(board);
+    for (int dy = -1; dy <= 1; dy += 2) {
+        if (on_board(pawn_x, sy + dy) && is_attacker(pawn_x, sy + dy, 'P', 'P')) {
+            return true;
+        }
+    }
+
+    for (const auto& delta : KNIGHT_DELTAS) {
+        auto x = sx + delta[0];
+        auto y = sy + delta[1];
+        if (on_board(x, y) && is_attacker(x, y, 'N', 'N')) {
+            return true;
+        }
+    }
+
+    for (const auto& delta : KING_DELTAS) {
+        auto x = sx + delta[0];
+        auto y = sy + delta[1];
+        if (on_board(x, y) && is_attacker(x, y, 'K', 'K')) {
+            return true;
+        }
+    }
+
+    // follow the rays until the first piece is hit
+    auto slider_attacks = [&](const int (&directions)[4][2], char name) {
+        for (const auto& direction : directions) {
+            auto x = sx + direction[0];
+            auto y = sy + direction[1];
+
+            while (on_board(x, y)) {
+                if (board.board[x][y]) {
+                    if (is_attacker(x, y, name, 'Q')) {
+                        return true;
+                    }
+                    break;
+                }
+                x += direction[0];
+                y += direction[1];
+            }
+        }
+        return false;
+    };
+
+    return slider_attacks(DIAGONALS, 'B') || slider_attacks(STRAIGHTS, 'R');
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include "../gameboard/GameBoard.hpp"
+#include "../color/Color.hpp"
+#include "../position/Move.hpp"
+#include "MoveList.hpp"
+
+// what a move does to the king of the opponent
+enum class CheckState {
+    NONE,
+    CHECK,
+    CHECKMATE
+};
+
+// the kinds of moves a generator creates. the quiescence search only needs the captures,
+// and a king in check only the moves that may save it
+enum class GenType {
+    ALL,
+    CAPTURES, // captures, en passant included, and pawn pushes promoting to a queen
+    QUIETS,   // every other move, CAPTURES and QUIETS together are ALL
+    EVASIONS  // for a king in check: king moves, captures of a single checking piece and blocks
+};
+
+// move generator of the engine
+// GameBoard::get_valid_moves_for creates a copy of the whole board for every move it validates,
+// which is fine for a player choosing one piece, but far too slow for a search.
+// This generator creates the moves of all pieces at once
+// and checks them for legality by moving the pieces in place and back again.
+// The private functions are templates on the color of the player and the kind of moves, so every
+// instantiation compares the pieces with a constant color and leaves out the moves it does not create.
+// The public functions choose the instantiation for the player at runtime.
+// The checks, pins and attacked fields of a king are computed once per position and kept
+// in the KingSafety of the gameboard, which turns most legality checks into a lookup.
+class MoveGen {
+    template<Color Us> static int pawn_direction(const GameBoard& board);
+
+    template<Color Us> static void generate_type(const GameBoard& board, GenType type, MoveList& moves);
+    template<Color Us, GenType Type> static void generate_moves(const GameBoard& board, MoveList& moves);
+    template<Color Us> static void legal_moves(GameBoard& board, GenType type, MoveList& moves);
+    template<Color Us> static KingSafety& find_checks(const GameBoard& board);
+    template<Color Us> static KingSafety& find_attacks(const GameBoard& board);
+
+    template<Color Us, GenType Type> static void add_pawn_moves(const GameBoard& board, Position position, uint64_t targets, MoveList& moves);
+    template<Color Us, GenType Type> static void add_en_passant_moves(const GameBoard& board, uint64_t targets, MoveList& moves);
+    template<Color Us, GenType Type> static void add_step_moves(const GameBoard& board, Position position, const int (&deltas)[8][2], uint64_t targets, MoveList& moves);
+    template<Color Us, GenType Type> static void add_slider_moves(const GameBoard& board, Position position, const int (&directions)[4][2], uint64_t targets, MoveList& moves);
+    template<Color Us> static void add_castling_moves(const GameBoard& board, Position king_pos, MoveList& moves);
+
+    template<Color Us> static bool is_legal(GameBoard& board, const Move& move, Position king_pos);
+    template<Color Us> static bool is_legal(GameBoard& board, const Move& move, const KingSafety& safety);
+    template<Color By> static bool is_square_attacked(const GameBoard& board, Position square);
+
+public:
+    static void generate_pseudo_legal(const GameBoard& board, Color us, MoveList& moves, GenType type = GenType::ALL);
+    static void generate_legal(GameBoard& board, Color us, MoveList& moves, GenType type = GenType::ALL);
+    static void generate_castling(GameBoard& board, Position king_pos, Color us, MoveList& moves);
+    [[nodiscard]] static bool is_legal(GameBoard& board, Color us, const Move& move, Position king_pos);
+    [[nodiscard]] static bool has_legal_move(GameBoard& board, Color us);
+
+    [[nodiscard]] static bool is_square_attacked(const GameBoard& board, Position square, Color by);
+    [[nodiscard]] static bool in_check(const GameBoard& board, Color color);
+    [[nodiscard]] static const KingSafety& king_safety(const GameBoard& board, Color color);
+    [[nodiscard]] static Position find_king(const GameBoard& board, Color color);
+    [[nodiscard]] static bool is_capture(const GameBoard& board, const Move& move);
+    [[nodiscard]] static CheckState check_state_after(GameBoard& board, Color us, const Move& move);
+};
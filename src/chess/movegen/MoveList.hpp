@@ -0,0 +1,61 @@
+#pragma once
+#include "../position/Move.hpp"
+
+// fixed size list of moves
+// the engine creates one list per searched position,
+// so it lives on the stack instead of allocating like VecPos
+class MoveList {
+public:
+    static constexpr int CAPACITY = 256;
+
+private:
+    Move moves[CAPACITY];
+    int count{0};
+public:
+    MoveList() = default;
+    ~MoveList() = default;
+
+    void push_back(const Move& move) {
+        moves[count++] = move;
+    }
+
+    void clear() {
+        count = 0;
+    }
+
+    [[nodiscard]] int size() const {
+        return count;
+    }
+
+    [[nodiscard]] bool empty() const {
+        return count == 0;
+    }
+
+    [[nodiscard]] bool contains(const Move& move) const {
+        return std::find(begin(), end(), move) != end();
+    }
+
+    Move& operator[](int index) {
+        return moves[index];
+    }
+
+    const Move& operator[](int index) const {
+        return moves[index];
+    }
+
+    Move* begin() {
+        return moves;
+    }
+
+    Move* end() {
+        return moves + count;
+    }
+
+    [[nodiscard]] const Move* begin() const {
+        return moves;
+    }
+
+    [[nodiscard]] const Move* end() const {
+        return moves + count;
+    }
+};
@@ -0,0 +1,242 @@
+#include "Notation.hpp"
+#include "../movegen/MoveGen.hpp"
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+    void append_square(MoveText& text, Position square) {
+        text.push_back(static_cast<char>('a' + square.get_y()));
+        text.push_back(static_cast<char>('1' + square.get_x()));
+    }
+
+    bool is_castling(const GameBoard& board, const Move& move) {
+        CastlingMove castling;
+        return board.get_castling_move(move.get_from(), move.get_to(), castling);
+    }
+
+    bool is_square(char file, char rank) {
+        return file >= 'a' && file <= 'h' && rank >= '1' && rank <= '8';
+    }
+}
+
+// *****************************************************
+// Public Methods
+// *****************************************************
+
+/**
+ * Converts a move into the long algebraic notation of the uci protocol, like e2e4 or e7e8q.
+ * @param board The gameboard before the move.
+ * @param move The move, relative to the orientation of the board.
+ */
+MoveText Notation::to_uci(const GameBoard& board, const Move& move) {
+    MoveText text;
+    append_square(text, board.absolute(move.get_from()));
+    append_square(text, board.absolute(move.get_to()));
+
+    if (move.get_promotion() != ' ') {
+        text.push_back(static_cast<char>(move.get_promotion() - 'A' + 'a'));
+    }
+
+    return text;
+}
+
+/**
+ * Finds the legal move written in the long algebraic notation.
+ * @return The move, an invalid move if it is not legal.
+ */
+Move Notation::from_uci(GameBoard& board, Color side_to_move, std::string_view uci) {
+    MoveList legal_moves;
+    MoveGen::generate_legal(board, side_to_move, legal_moves);
+    return from_uci(board, legal_moves, uci);
+}
+
+Move Notation::from_uci(const GameBoard& board, const MoveList& legal_moves, std::string_view uci) {
+    if (uci.size() < 4 || uci.size() > 5 || !is_square(uci[0], uci[1]) || !is_square(uci[2], uci[3])) {
+        return {};
+    }
+
+    auto from = board.absolute({uci[1] - '1', uci[0] - 'a'});
+    auto to = board.absolute({uci[3] - '1', uci[2] - 'a'});
+    auto promotion = (uci.size() == 5) ? static_cast<char>(uci[4] - 'a' + 'A') : ' ';
+
+    for (const auto& move : legal_moves) {
+        if (move.get_from() == from && move.get_to() == to && move.get_promotion() == promotion) {
+            return move;
+        }
+    }
+
+    return {};
+}
+
+/**
+ * Converts a move into the standard algebraic notation, like Nbd7, exd6, e8=Q+ or O-O.
+ * @param board The gameboard before the move, it is unchanged after the call.
+ * @param side_to_move The color of the player making the move.
+ * @param move A legal move.
+ */
+MoveText Notation::to_san(GameBoard& board, Color side_to_move, const Move& move) {
+    // only pieces other than pawns can need the other moves to tell them apart
+    MoveList legal_moves;
+    auto name = board.get_piece(move.get_from())->get_name();
+    if (name != 'P' && name != 'K') {
+        MoveGen::generate_legal(board, side_to_move, legal_moves);
+    }
+
+    return to_san(board, side_to_move, move, legal_moves);
+}
+
+MoveText Notation::to_san(GameBoard& board, Color side_to_move, const Move& move, const MoveList& legal_moves) {
+    MoveText text;
+    auto name = board.get_piece(move.get_from())->get_name();
+    auto from = board.absolute(move.get_from());
+    auto to = board.absolute(move.get_to());
+
+    CastlingMove castling;
+    if (board.get_castling_move(move.get_from(), move.get_to(), castling)) {
+        text.append((castling.side == KING_SIDE) ? "O-O" : "O-O-O");
+    } else {
+        auto capture = MoveGen::is_capture(board, move);
+
+        if (name != 'P') {
+            text.push_back(name);
+
+            // another piece of the same type can move to the same field,
+            // the file is preferred, then the rank and then both
+            auto ambiguous = false;
+            auto same_file = false;
+            auto same_rank = false;
+
+            for (const auto& other : legal_moves) {
+                if (other.get_to() != move.get_to() || other.get_from() == move.get_from() ||
+                    board.get_piece(other.get_from())->get_name() != name) {
+                    continue;
+                }
+
+                auto other_from = board.absolute(other.get_from());
+                ambiguous = true;
+                same_file = same_file || other_from.get_y() == from.get_y();
+                same_rank = same_rank || other_from.get_x() == from.get_x();
+            }
+
+            if (ambiguous && (!same_file || same_rank)) {
+                text.push_back(static_cast<char>('a' + from.get_y()));
+            }
+            if (ambiguous && same_file) {
+                text.push_back(static_cast<char>('1' + from.get_x()));
+            }
+        } else if (capture) {
+            text.push_back(static_cast<char>('a' + from.get_y()));
+        }
+
+        if (capture) {
+            text.push_back('x');
+        }
+
+        append_square(text, to);
+
+        if (move.get_promotion() != ' ') {
+            text.push_back('=');
+            text.push_back(move.get_promotion());
+        }
+    }
+
+    switch (MoveGen::check_state_after(board, side_to_move, move)) {
+        case CheckState::CHECK:
+            text.push_back('+');
+            break;
+        case CheckState::CHECKMATE:
+            text.push_back('#');
+            break;
+        case CheckState::NONE:
+            break;
+    }
+
+    return text;
+}
+
+/**
+ * Finds the legal move written in the standard algebraic notation.
+ * Check marks and annotations like ! or ? are ignored.
+ * @param board The gameboard, it is unchanged after the call.
+ * @param side_to_move The color of the player making the move.
+ * @param san The move.
+ * @return The move, an invalid move if there is no such legal move or more than one.
+ */
+Move Notation::from_san(GameBoard& board, Color side_to_move, std::string_view san) {
+    MoveList legal_moves;
+    MoveGen::generate_legal(board, side_to_move, legal_moves);
+    return from_san(board, legal_moves, san);
+}
+
+Move Notation::from_san(const GameBoard& board, const MoveList& legal_moves, std::string_view san) {
+    while (!san.empty() && std::strchr("+#!?", san.back())) {
+        san.remove_suffix(1);
+    }
+
+    if (san == "O-O" || san == "0-0" || san == "O-O-O" || san == "0-0-0") {
+        auto side = (san.size() == 3) ? KING_SIDE : QUEEN_SIDE;
+
+        for (const auto& move : legal_moves) {
+            CastlingMove castling;
+            if (board.get_castling_move(move.get_from(), move.get_to(), castling) && castling.side == side) {
+                return move;
+            }
+        }
+        return {};
+    }
+
+    auto name = 'P';
+    if (!san.empty() && std::strchr("KQRBN", san.front())) {
+        name = san.front();
+        san.remove_prefix(1);
+    }
+
+    auto promotion = ' ';
+    if (auto equals = san.find('='); equals != std::string_view::npos) {
+        promotion = (equals + 1 < san.size()) ? san[equals + 1] : ' ';
+        san = san.substr(0, equals);
+    } else if (name == 'P' && !san.empty() && std::strchr("QRBN", san.back())) {
+        promotion = san.back();
+        san.remove_suffix(1);
+    }
+
+    if (san.size() < 2 || !is_square(san[san.size() - 2], san[san.size() - 1])) {
+        return {};
+    }
+
+    auto to_file = san[san.size() - 2] - 'a';
+    auto to_rank = san[san.size() - 1] - '1';
+    san.remove_suffix(2);
+
+    // the rest is the optional file and rank of the piece and the capture mark
+    auto from_file = -1;
+    auto from_rank = -1;
+    for (auto c : san) {
+        if (c >= 'a' && c <= 'h') {
+            from_file = c - 'a';
+        } else if (c >= '1' && c <= '8') {
+            from_rank = c - '1';
+        } else if (c != 'x' && c != ':' && c != '-') {
+            return {};
+        }
+    }
+
+    Move result;
+    auto matches = 0;
+
+    for (const auto& move : legal_moves) {
+        auto from = board.absolute(move.get_from());
+        auto to = board.absolute(move.get_to());
+
+        if (board.get_piece(move.get_from())->get_name() != name || to.get_y() != to_file || to.get_x() != to_rank ||
+            (from_file >= 0 && from.get_y() != from_file) || (from_rank >= 0 && from.get_x() != from_rank) ||
+            move.get_promotion() != promotion || is_castling(board, move)) {
+            continue;
+        }
+
+        result = move;
+        ++matches;
+    }
+
+    return (matches == 1) ? result : Move{};
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "../gameboard/GameBoard.hpp"
+#include "../color/Color.hpp"
+#include "../position/Move.hpp"
+#include "../movegen/MoveList.hpp"
+
+// a move as text, the characters are stored inline so formatting a move allocates nothing.
+// the longest moves are like Qa1xb2# or exd8=Q+
+class MoveText {
+public:
+    static constexpr size_t CAPACITY = 8;
+
+private:
+    char text[CAPACITY]{};
+    uint8_t length{0};
+
+public:
+    void push_back(char c) {
+        if (length < CAPACITY) {
+            text[length++] = c;
+        }
+    }
+
+    void append(std::string_view characters) {
+        for (auto c : characters) {
+            push_back(c);
+        }
+    }
+
+    [[nodiscard]] std::string_view view() const {
+        return {text, length};
+    }
+
+    [[nodiscard]] std::string str() const {
+        return std::string(view());
+    }
+
+    [[nodiscard]] bool empty() const {
+        return length == 0;
+    }
+
+    [[nodiscard]] size_t size() const {
+        return length;
+    }
+};
+
+// parses and formats moves in the standard algebraic notation (Nbd7, exd6, e8=Q+, O-O)
+// and the long algebraic notation of the uci protocol (b8d7, e5d6, e7e8q, e1g1).
+// chess960 castling is written in uci as the king capturing its own rook, like b1a1.
+// the functions that take the legal moves of the position do not generate them again,
+// which is faster when many moves of the same position are converted
+class Notation {
+public:
+    [[nodiscard]] static MoveText to_uci(const GameBoard& board, const Move& move);
+    [[nodiscard]] static Move from_uci(GameBoard& board, Color side_to_move, std::string_view uci);
+    [[nodiscard]] static Move from_uci(const GameBoard& board, const MoveList& legal_moves, std::string_view uci);
+
+    [[nodiscard]] static MoveText to_san(GameBoard& board, Color side_to_move, const Move& move);
+    [[nodiscard]] static MoveText to_san(GameBoard& board, Color side_to_move, const Move& move, const MoveList& legal_moves);
+    [[nodiscard]] static Move from_san(GameBoard& board, Color side_to_move, std::string_view san);
+    [[nodiscard]] static Move from_san(const GameBoard& board, const MoveList& legal_moves, std::string_view san);
+};
@@ -0,0 +1,286 @@
+#include "Pgn.hpp"
+#include "../fen/Fen.hpp"
+#include "../movegen/MoveGen.hpp"
+#include "../notation/Notation.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    bool is_result(std::string_view token) {
+        return token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*";
+    }
+
+}
+
+// *****************************************************
+// Public Methods
+// *****************************************************
+
+std::string_view PgnGame::get_tag(std::string_view name) const {
+    for (const auto& [tag, value] : tags) {
+        if (tag == name) {
+            return value;
+        }
+    }
+    return {};
+}
+
+void PgnGame::set_tag(const std::string& name, const std::string& value) {
+    for (auto& [tag, old_value] : tags) {
+        if (tag == name) {
+            old_value = value;
+            return;
+        }
+    }
+    tags.emplace_back(name, value);
+}
+
+/**
+ * Removes everything, but keeps the memory for the next game.
+ */
+void PgnGame::clear() {
+    tags.clear();
+    moves.clear();
+    result.assign(1, '*');
+}
+
+/**
+ * Writes the game with its tags, the lines of the moves are at most 80 characters long.
+ */
+void Pgn::write(const PgnGame& game, std::ostream& out) {
+    for (const auto& [name, value] : game.tags) {
+        out << '[' << name << " \"";
+        for (auto c : value) {
+            if (c == '"' || c == '\\') {
+                out << '\\';
+            }
+            out << c;
+        }
+        out << "\"]\n";
+    }
+    out << '\n';
+
+    // a game that does not start from the start position gets the first move number and color from its FEN
+    auto number = 1;
+    auto white = true;
+    if (auto fen = game.get_tag("FEN"); !fen.empty()) {
+        std::istringstream fields{std::string(fen)};
+        std::string field;
+        for (int i = 0; fields >> field; ++i) {
+            if (i == 1) {
+                white = field != "b";
+            } else if (i == 5) {
+                number = std::max(1, std::atoi(field.c_str()));
+            }
+        }
+    }
+
+    std::string line;
+    auto append = [&out, &line](const std::string& token) {
+        if (!line.empty() && line.size() + 1 + token.size() >= 80) {
+            out << line << '\n';
+            line.clear();
+        }
+        if (!line.empty()) {
+            line += ' ';
+        }
+        line += token;
+    };
+
+    // the move number stays on the same line as the move
+    for (size_t i = 0; i < game.moves.size(); ++i) {
+        if (white) {
+            append(std::to_string(number) + ". " + game.moves[i]);
+        } else if (i == 0) {
+            append(std::to_string(number) + "... " + game.moves[i]);
+        } else {
+            append(game.moves[i]);
+        }
+
+        if (!white) {
+            ++number;
+        }
+        white = !white;
+    }
+
+    append(game.result);
+    out << line << "\n\n";
+}
+
+/**
+ * Plays the moves of the game on a gameboard to check that all of them are legal.
+ * @param game The game, it starts from the FEN tag if it has one.
+ * @param error Set to the reason if the game is not valid.
+ * @param visitor Optionally called for every legal move, before it is made.
+ * @return true if every move of the game is legal.
+ */
+bool Pgn::replay(const PgnGame& game, std::string& error, const MoveVisitor& visitor) {
+    auto side_to_move = Color::WHITE;
+    auto fen = game.get_tag("FEN");
+
+    try {
+        auto board = fen.empty() ? GameBoard{GameTest::NORMAL} : Fen::parse(fen, side_to_move);
+
+        for (size_t i = 0; i < game.moves.size(); ++i) {
+            MoveList legal_moves;
+            MoveGen::generate_legal(board, side_to_move, legal_moves);
+            auto move = Notation::from_san(board, legal_moves, game.moves[i]);
+
+            if (!move.is_valid()) {
+                error = "illegal or ambiguous move " + game.moves[i] + " at half move " + std::to_string(i + 1);
+                return false;
+            }
+
+            if (visitor) {
+                visitor(board, side_to_move, move);
+            }
+
+            board.make_move(move);
+            board.flip();
+            side_to_move = enemy_of(side_to_move);
+        }
+    } catch (const std::invalid_argument& e) {
+        error = e.what();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Reads the next game.
+ * A game ends with its result, or with the tags of the next game if the result is missing.
+ * @param game Set to the game.
+ * @return false if there are no more games.
+ */
+bool PgnReader::next(PgnGame& game) {
+    game.clear();
+    in_comment = false;
+    variation_depth = 0;
+
+    auto has_moves = false;
+
+    while (has_pending_line || std::getline(in, line)) {
+        has_pending_line = false;
+
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+
+        // lines starting with % are escaped, they are ignored
+        if (line.empty() || line[0] == '%') {
+            continue;
+        }
+
+        if (line[0] == '[' && !in_comment) {
+            if (has_moves) {
+                has_pending_line = true;
+                return true;
+            }
+            parse_tag(game);
+            continue;
+        }
+
+        has_moves = true;
+        if (parse_moves(game)) {
+            return true;
+        }
+    }
+
+    return has_moves || !game.tags.empty();
+}
+
+// *****************************************************
+// Private Methods
+// *****************************************************
+
+/**
+ * Reads a tag like [White "Fischer, Robert J."] from the current line.
+ * @return false if the line is not a valid tag.
+ */
+bool PgnReader::parse_tag(PgnGame& game) const {
+    auto space = line.find(' ');
+    auto first_quote = line.find('"');
+    auto last_quote = line.rfind('"');
+
+    if (space == std::string::npos || first_quote == std::string::npos || first_quote == last_quote) {
+        return false;
+    }
+
+    std::string value;
+    for (auto i = first_quote + 1; i < last_quote; ++i) {
+        if (line[i] == '\\' && i + 1 < last_quote) {
+            ++i;
+        }
+        value += line[i];
+    }
+
+    game.tags.emplace_back(line.substr(1, space - 1), std::move(value));
+    return true;
+}
+
+/**
+ * Reads the moves of the current line, comments can span several lines.
+ * @return true if the line contains the result, which ends the game.
+ */
+bool PgnReader::parse_moves(PgnGame& game) {
+    std::string_view text = line;
+    size_t i = 0;
+
+    while (i < text.size()) {
+        auto c = text[i];
+
+        if (in_comment) {
+            in_comment = c != '}';
+            ++i;
+            continue;
+        }
+
+        if (c == ';') {
+            break;
+        }
+
+        // a } without a comment is skipped as well, a token can not start with it
+        if (c == '{' || c == '}' || c == '(' || c == ')' || std::isspace(static_cast<unsigned char>(c))) {
+            in_comment = c == '{';
+            variation_depth += (c == '(') ? 1 : (c == ')' && variation_depth > 0) ? -1 : 0;
+            ++i;
+            continue;
+        }
+
+        auto start = i;
+        while (i < text.size() && !std::isspace(static_cast<unsigned char>(text[i])) && std::string_view("{}();").find(text[i]) == std::string_view::npos) {
+            ++i;
+        }
+        auto token = text.substr(start, i - start);
+
+        // moves of variations and numeric annotation glyphs like $1
+        if (variation_depth > 0 || token[0] == '$') {
+            continue;
+        }
+
+        if (is_result(token)) {
+            game.result = token;
+            return true;
+        }
+
+        // move numbers like 12. or 12... can be written without a space before the move
+        auto digits = token.find_first_not_of("0123456789");
+        if (digits == std::string_view::npos) {
+            continue;
+        }
+        if (digits > 0 && token[digits] == '.') {
+            auto move_start = token.find_first_not_of('.', digits);
+            token = (move_start == std::string_view::npos) ? std::string_view{} : token.substr(move_start);
+        }
+
+        if (!token.empty()) {
+            game.moves.emplace_back(token);
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "../gameboard/GameBoard.hpp"
+#include "../color/Color.hpp"
+#include "../position/Move.hpp"
+
+// a game in the portable game notation, the moves are kept in the standard algebraic notation
+struct PgnGame {
+    std::vector<std::pair<std::string, std::string>> tags;
+    std::vector<std::string> moves;
+    std::string result{"*"};
+
+    [[nodiscard]] std::string_view get_tag(std::string_view name) const;
+    void set_tag(const std::string& name, const std::string& value);
+    void clear();
+};
+
+// writes games and replays them, the moves are converted with Notation
+class Pgn {
+public:
+    static void write(const PgnGame& game, std::ostream& out);
+    // called with the gameboard before every move of a replayed game
+    using MoveVisitor = std::function<void(const GameBoard& board, Color side_to_move, const Move& move)>;
+
+    static bool replay(const PgnGame& game, std::string& error, const MoveVisitor& visitor = {});
+};
+
+// reads one game after the other from a stream, without reading the whole stream into memory.
+// comments, variations and numeric annotation glyphs are skipped
+class PgnReader {
+    std::istream& in;
+    std::string line;
+    bool has_pending_line{false};
+    bool in_comment{false};
+    int variation_depth{0};
+
+    bool parse_tag(PgnGame& game) const;
+    bool parse_moves(PgnGame& game);
+
+public:
+    explicit PgnReader(std::istream& in) : in(in) {}
+
+    bool next(PgnGame& game);
+};
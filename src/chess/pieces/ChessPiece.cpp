@@ -1,5 +1,10 @@
 #include "ChessPiece.hpp"
 
+// larger pieces would silently fall back to the global heap
+static_assert(sizeof(King) <= PiecePool::BLOCK_SIZE && sizeof(Queen) <= PiecePool::BLOCK_SIZE &&
+              sizeof(Rook) <= PiecePool::BLOCK_SIZE && sizeof(Bishop) <= PiecePool::BLOCK_SIZE &&
+              sizeof(Knight) <= PiecePool::BLOCK_SIZE && sizeof(Pawn) <= PiecePool::BLOCK_SIZE);
+
 // *****************************************************
 // Static ChessPiece Methods
 // *****************************************************
@@ -48,6 +53,23 @@ bool ChessPiece::is_empty(const std::unique_ptr<ChessPiece> (&board)[8][8], int
     return !board[x][y];
 }
 
+/**
+ * Get the index of the piece type, used by the engine for its tables
+ * @param name the name of the piece
+ * @return 0 to 5 for pawn, knight, bishop, rook, queen and king, -1 for an unknown name
+ */
+int ChessPiece::get_type_index(char name) {
+    switch (name) {
+        case 'P': return 0;
+        case 'N': return 1;
+        case 'B': return 2;
+        case 'R': return 3;
+        case 'Q': return 4;
+        case 'K': return 5;
+        default: return -1;
+    }
+}
+
 // *****************************************************
 // King Methods
 // *****************************************************
@@ -92,86 +114,6 @@ bool King::is_valid_delta(int &x, int &y) {
     return delta_changed(x, y);
 }
 
-VecPos King::get_diagonal_attackers(const std::unique_ptr<ChessPiece> (&board)[8][8], const Position position) const{
-    auto bishop = std::make_unique<Bishop>(this->get_color());
-    return bishop->get_moves_for(position, board);
-}
-
-VecPos King::get_straight_attackers(const std::unique_ptr<ChessPiece> (&board)[8][8], const Position position) const {
-    auto rook = std::make_unique<Rook>(this->get_color());
-    return rook->get_moves_for(position, board);
-}
-
-VecPos King::get_horse_attackers(const std::unique_ptr<ChessPiece> (&board)[8][8], const Position position) const {
-    auto horse = std::make_unique<Knight>(this->get_color());
-    return horse->get_moves_for(position, board);
-}
-
-/**
- * Check if the king is able to castle to the left or right.
- * @param position of the king
- * @param pPtr to the board
- * @param left check the left side or the right side?
- * @param color color of the current player
- * @param flipped is the board flipped?
- * @return A vector of positions that have possible castling moves
- */
-VecPos King::get_castling(const Position position, std::unique_ptr<ChessPiece> pPtr[8][8], bool left, Color color, bool flipped) {
-    VecPos valid_moves;
-
-    auto x = position.get_x();
-    auto y = position.get_y();
-
-    auto king = dynamic_cast<King*>(pPtr[x][y].get());
-
-    // if king already moved, return empty vector
-    if (king->has_moved()) {
-        return {};
-    }
-
-    // we need to act as if the board was flipped
-    // if it is flipped, we need to flip the -1 to plus 1
-    // -2 to +2 and so on
-    bool check = (color == Color::WHITE && !flipped) || (color == Color::BLACK && !flipped);
-
-    auto one = check ? 1 : -1;
-    auto two = check ? 2 : -2;
-    auto three = check ? 3 : -3;
-    auto four = check ? 4 : -4;
-
-    if (left) {
-        // check if left side of the king is empty
-        // y -4 would be the rook
-        if (!pPtr[x][y - one] && !pPtr[x][y - two] && !pPtr[x][y - three]) {
-            // check if there is a rook on the left side
-            auto rook = dynamic_cast<Rook*>(pPtr[x][y - four].get());
-            if (rook && !rook->has_moved()) {
-                auto move_one = Position(x, y - one);
-                auto new_position = Position(x, y - two);
-
-                valid_moves.push_back(move_one);
-                valid_moves.push_back(new_position);
-            }
-        }
-    } else {
-        // check if right side of the king is empty
-        // y + 3 would be the rook
-        if (!pPtr[x][y + one] && !pPtr[x][y + two]) {
-            // check if there is a rook on the right side
-            auto rook = dynamic_cast<Rook*>(pPtr[x][y + three].get());
-            if (rook && !rook->has_moved()) {
-                auto move_one = Position(x, y + one);
-                auto new_position = Position(x, y + two);
-
-                valid_moves.push_back(move_one);
-                valid_moves.push_back(new_position);
-            }
-        }
-    }
-
-    return valid_moves;
-}
-
 // *****************************************************
 // Queen Methods
 // *****************************************************
@@ -186,12 +128,12 @@ Queen::Queen(Color color) : ChessPiece(color) {
 
 VecPos Queen::get_moves_for(Position position, const std::unique_ptr<ChessPiece> (&board)[8][8]) {
     // We take advantage of the fact that the queen can move like a rook OR a bishop
-    auto bishop = std::make_unique<Bishop>(this->get_color());
-    auto rook = std::make_unique<Rook>(this->get_color());
+    Bishop bishop{this->get_color()};
+    Rook rook{this->get_color()};
 
     // We get the valid moves of the bishop and the rook.
-    auto bishop_moves = bishop->get_moves_for(position, board);
-    auto rook_moves = rook->get_moves_for(position, board);
+    auto bishop_moves = bishop.get_moves_for(position, board);
+    auto rook_moves = rook.get_moves_for(position, board);
 
     // We merge the two vectors.
     bishop_moves.insert(bishop_moves.end(), rook_moves.begin(), rook_moves.end());
@@ -373,25 +315,22 @@ VecPos Pawn::get_moves_for(Position position, const std::unique_ptr<ChessPiece>
     auto px = position.get_x();
     auto py = position.get_y();
 
-    bool enemy_ahead = false;
+    // the pawn can only move 2 up if the field 1 up is empty
+    bool blocked = true;
 
     // block for checking if the pawn can move 1 up
-    // this block also checks if there is an enemy 1 up
     {
         auto x = px + 1;
         auto y = py;
 
-        // check if new position is on board and empty or enemy
+        // check if new position is on board and empty
         if (
             is_on_board(x, y) &&
             is_empty(board, x, y)
         ) {
             auto new_position = Position(x, y);
             valid_moves.push_back(new_position);
-
-            if (is_enemy(board, x, y)) {
-                enemy_ahead = true;
-            }
+            blocked = false;
         }
     }
 
@@ -403,7 +342,7 @@ VecPos Pawn::get_moves_for(Position position, const std::unique_ptr<ChessPiece>
         // check if new position is on board and empty or enemy
         if (
             first_move &&
-            !enemy_ahead &&
+            !blocked &&
             is_on_board(x, y) &&
             is_empty(board, x, y)
         ) {
@@ -477,9 +416,9 @@ Position Pawn::get_en_passant(Position position, const std::unique_ptr<ChessPiec
         return {-1, -1};
     }
 
-    // if there is another piece directly behind the enemy pawn that moved last turn
+    // if there is another piece on the field the enemy pawn skipped last turn
     // the last move is not a move that allows en passant
-    if (board[enemy_pawn_x - 1][enemy_pawn_y] != nullptr) {
+    if (board[enemy_pawn_x + 1][enemy_pawn_y] != nullptr) {
         return {-1, -1};
     }
 
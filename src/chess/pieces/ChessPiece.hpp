@@ -8,10 +8,11 @@ class ChessPiece;
 #include "../color/Color.hpp"
 #include "../position/Position.hpp"
 #include "../position/LastMove.hpp"
+#include "PiecePool.hpp"
 
 class ChessPiece {
     Color color;
-    std::string symbol;
+    const char* symbol{""}; // a glyph of a static table, the pieces are copied far too often to own a string
 
 protected:
     static bool delta_changed(int& x, int& y) ;
@@ -24,20 +25,31 @@ public:
     ChessPiece(Color c) : color(c) {}
     virtual ~ChessPiece() = default;
 
+    // every board copy creates all of its pieces, they come from the thread local pool instead of the heap
+    static void* operator new(size_t size) {
+        return PiecePool::allocate(size);
+    }
+
+    static void operator delete(void* block, size_t size) noexcept {
+        PiecePool::release(block, size);
+    }
+
     [[nodiscard]] Color get_color() const {
         return color;
     }
 
-    void set_symbol(std::string s) {
-        this->symbol = std::move(s);
+    void set_symbol(const char* s) {
+        this->symbol = s;
     }
 
-    [[nodiscard]] std::string get_symbol() const {
+    [[nodiscard]] const char* get_symbol() const {
         return symbol;
     }
 
     virtual VecPos get_moves_for(Position position, const std::unique_ptr<ChessPiece> (&board)[8][8]) = 0;
     virtual char get_name() = 0;
+
+    [[nodiscard]] static int get_type_index(char name);
 };
 
 class King : public ChessPiece {
@@ -52,11 +64,6 @@ public:
     }
 
     VecPos get_moves_for(Position position, const std::unique_ptr<ChessPiece> (&board)[8][8]) override;
-    [[nodiscard]] VecPos get_diagonal_attackers(const std::unique_ptr<ChessPiece> (&board)[8][8], Position position) const;
-    [[nodiscard]] VecPos get_straight_attackers(const std::unique_ptr<ChessPiece> (&board)[8][8], Position position) const;
-    [[nodiscard]] VecPos get_horse_attackers(const std::unique_ptr<ChessPiece> (&board)[8][8], Position position) const;
-
-    static VecPos get_castling(Position position, std::unique_ptr<ChessPiece> pPtr[8][8], bool left, Color color, bool flipped);
 
     void set_moved(bool b) {
         first_move = !b;
@@ -138,6 +145,10 @@ public:
         first_move = !b;
     }
 
+    [[nodiscard]] bool has_moved() const {
+        return !first_move;
+    }
+
     VecPos get_moves_for(Position position, const std::unique_ptr<ChessPiece> (&board)[8][8]) override;
     static Position get_en_passant(Position position, const std::unique_ptr<ChessPiece> (&board)[8][8], const LastMove& last_move);
 };
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "PiecePool.hpp"
+#include <mutex>
+#include <new>
+
+namespace {
+    // a free block, the first block of a batch also links the batches of the shared pool
+    struct FreeBlock {
+        FreeBlock* next;
+        FreeBlock* next_batch;
+        size_t batch_size;
+    };
+
+    static_assert(sizeof(FreeBlock) <= PiecePool::BLOCK_SIZE);
+
+    // the free blocks of one thread. it is trivially destructible on purpose,
+    // pieces of static boards may still be freed after the thread local objects are gone
+    struct LocalPool {
+        FreeBlock* head;
+        size_t size;
+    };
+
+    thread_local LocalPool local_pool{nullptr, 0};
+
+    std::mutex shared_mutex;
+    FreeBlock* shared_batches{nullptr};
+
+    /**
+     * Takes up to the given number of blocks from the front of the local list.
+     * @return The first block of the batch, with its size set.
+     */
+    FreeBlock* take_batch(LocalPool& pool, size_t count) {
+        auto batch = pool.head;
+        auto last = batch;
+        for (size_t i = 1; i < count; ++i) {
+            last = last->next;
+        }
+
+        pool.head = last->next;
+        pool.size -= count;
+        last->next = nullptr;
+        batch->batch_size = count;
+        return batch;
+    }
+
+    void give_back(FreeBlock* batch) {
+        std::lock_guard lock(shared_mutex);
+        batch->next_batch = shared_batches;
+        shared_batches = batch;
+    }
+
+    /**
+     * Fills the empty local list, with a batch of the shared pool or with a new chunk of memory.
+     */
+    void refill(LocalPool& pool) {
+        {
+            std::lock_guard lock(shared_mutex);
+            if (shared_batches) {
+                pool.head = shared_batches;
+                pool.size = shared_batches->batch_size;
+                shared_batches = shared_batches->next_batch;
+                return;
+            }
+        }
+
+        auto chunk = static_cast<std::byte*>(::operator new(PiecePool::BATCH_SIZE * PiecePool::BLOCK_SIZE));
+        FreeBlock* head = nullptr;
+        for (auto i = PiecePool::BATCH_SIZE; i > 0; --i) {
+            auto block = new (chunk + (i - 1) * PiecePool::BLOCK_SIZE) FreeBlock{head, nullptr, 0};
+            head = block;
+        }
+
+        pool.head = head;
+        pool.size = PiecePool::BATCH_SIZE;
+    }
+
+    // hands the free blocks of a finished thread to the shared pool, so other threads can reuse them
+    struct ThreadExit {
+        ~ThreadExit() {
+            if (local_pool.size > 0) {
+                give_back(take_batch(local_pool, local_pool.size));
+            }
+        }
+    };
+
+    thread_local ThreadExit thread_exit;
+
+    // registers the thread for the hand over of its blocks at its end, only needed when its list was empty
+    void register_thread() {
+        (void) &thread_exit;
+    }
+}
+
+// *****************************************************
+// Public Methods
+// *****************************************************
+
+/**
+ * @param size The size of the object, larger objects than a block come from the global heap.
+ * @return Memory for the object.
+ */
+void* PiecePool::allocate(size_t size) {
+    if (size > BLOCK_SIZE) {
+        return ::operator new(size);
+    }
+
+    auto& pool = local_pool;
+    if (!pool.head) {
+        register_thread();
+        refill(pool);
+    }
+
+    auto block = pool.head;
+    pool.head = block->next;
+    --pool.size;
+    return block;
+}
+
+/**
+ * @param block The memory returned by allocate.
+ * @param size The size it was allocated with.
+ */
+void PiecePool::release(void* block, size_t size) noexcept {
+    if (size > BLOCK_SIZE) {
+        ::operator delete(block);
+        return;
+    }
+
+    auto& pool = local_pool;
+    if (!pool.head) {
+        register_thread();
+    }
+
+    pool.head = new (block) FreeBlock{pool.head, nullptr, 0};
+    ++pool.size;
+
+    // a thread that only frees blocks hands them on, instead of collecting them forever
+    if (pool.size > 2 * BATCH_SIZE) {
+        give_back(take_batch(pool, BATCH_SIZE));
+    }
+}
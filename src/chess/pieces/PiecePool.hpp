@@ -0,0 +1,16 @@
+#pragma once
+#include <cstddef>
+
+// the pieces of all boards are allocated from blocks of a fixed size instead of the global heap.
+// every thread keeps its own list of free blocks, so the board copies of a search need no lock at all.
+// blocks are exchanged with the shared pool only in whole batches, when a thread runs out of blocks
+// or has freed far more than it allocated, e.g. boards created by one thread and destroyed by another.
+// the memory is reused but never given back to the system, its size is the most pieces ever alive at once
+class PiecePool {
+public:
+    static constexpr size_t BLOCK_SIZE = 32;
+    static constexpr size_t BATCH_SIZE = 512; // the blocks of one batch, 16 kb
+
+    [[nodiscard]] static void* allocate(size_t size);
+    static void release(void* block, size_t size) noexcept;
+};
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstdint>
+#include "Position.hpp"
+
+// class that describes a single move of the engine
+// like every other position in the game, from and to are relative
+// to the current orientation of the gameboard
+class Move {
+    Position from;
+    Position to;
+    char promotion;
+public:
+    Move(Position from, Position to, char promotion = ' ') : from(from), to(to), promotion(promotion) {}
+    Move() : from(), to(), promotion(' ') {}
+    Move(const Move& other) = default;
+    Move& operator=(const Move& other) = default;
+    ~Move() = default;
+
+    [[nodiscard]] Position get_from() const {
+        return from;
+    }
+
+    [[nodiscard]] Position get_to() const {
+        return to;
+    }
+
+    [[nodiscard]] char get_promotion() const {
+        return promotion;
+    }
+
+    [[nodiscard]] bool is_valid() const {
+        return from.is_valid() && to.is_valid();
+    }
+
+    /**
+     * Packs the move into 16 bits.
+     * 6 bits for the from square, 6 bits for the to square and 3 bits for the promotion piece.
+     * An invalid move is packed as 0.
+     */
+    [[nodiscard]] uint16_t to_packed() const {
+        if (!is_valid()) {
+            return 0;
+        }
+
+        auto from_square = from.get_x() * 8 + from.get_y();
+        auto to_square = to.get_x() * 8 + to.get_y();
+        int promotion_index;
+
+        switch (promotion) {
+            case 'N': promotion_index = 1; break;
+            case 'B': promotion_index = 2; break;
+            case 'R': promotion_index = 3; break;
+            case 'Q': promotion_index = 4; break;
+            default: promotion_index = 0; break;
+        }
+
+        return static_cast<uint16_t>(from_square | (to_square << 6) | (promotion_index << 12));
+    }
+
+    /**
+     * Unpacks a move that was packed with to_packed.
+     */
+    [[nodiscard]] static Move from_packed(uint16_t packed) {
+        if (packed == 0) {
+            return {};
+        }
+
+        const char promotions[] = {' ', 'N', 'B', 'R', 'Q', ' ', ' ', ' '};
+        auto from_square = packed & 63;
+        auto to_square = (packed >> 6) & 63;
+
+        return {
+            Position(from_square / 8, from_square % 8),
+            Position(to_square / 8, to_square % 8),
+            promotions[(packed >> 12) & 7]
+        };
+    }
+
+    friend
+    bool operator==(const Move& lhs, const Move& rhs) {
+        return lhs.from == rhs.from &&
+               lhs.to == rhs.to &&
+               lhs.promotion == rhs.promotion;
+    }
+};
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// stack of the zobrist hashes of all positions that were on the board before the current one
+// used to detect repetitions, only positions since the last capture or pawn move
+// (the halfmove clock of the gameboard) have to be looked at
+class PositionHistory {
+    std::vector<uint64_t> keys;
+public:
+    PositionHistory() {
+        keys.reserve(256);
+    }
+    PositionHistory(const PositionHistory& other) = default;
+    PositionHistory& operator=(const PositionHistory& other) = default;
+    ~PositionHistory() = default;
+
+    void push(uint64_t key) {
+        keys.push_back(key);
+    }
+
+    void pop() {
+        keys.pop_back();
+    }
+
+    void clear() {
+        keys.clear();
+    }
+
+    [[nodiscard]] size_t size() const {
+        return keys.size();
+    }
+
+    /**
+     * Counts how often the position was on the board before.
+     * Only every second position has the same player to move,
+     * and no position before the last irreversible move can repeat.
+     * @param key The zobrist hash of the current position.
+     * @param halfmove_clock The number of moves since the last capture or pawn move.
+     * @return The number of earlier occurrences of the position.
+     */
+    [[nodiscard]] int repetitions(uint64_t key, int halfmove_clock) const {
+        auto size = static_cast<int>(keys.size());
+        auto end = std::max(0, size - halfmove_clock);
+        int count = 0;
+
+        for (auto i = size - 2; i >= end; i -= 2) {
+            if (keys[static_cast<size_t>(i)] == key) {
+                ++count;
+            }
+        }
+
+        return count;
+    }
+};
@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+
+// the pseudo random number generator of the engine (xoshiro256**), used wherever a choice is made randomly.
+// the same seed gives the same numbers with every compiler and standard library, unlike rand() or the
+// distributions of <random>, and every game or thread owns its generator, so no state is shared between threads.
+// it can be used with the distributions of <random>, but below is the portable way to get a number in a range
+class Random {
+    uint64_t state[4]{};
+
+    static constexpr uint64_t rotate_left(uint64_t value, int bits) {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    // the state is filled with splitmix64, so similar seeds still give unrelated sequences
+    static constexpr uint64_t splitmix64(uint64_t& value) {
+        value += 0x9E3779B97F4A7C15ULL;
+        auto z = value;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+public:
+    using result_type = uint64_t;
+
+    /**
+     * @param seed The seed, the same seed always gives the same sequence.
+     * @param stream Creates an independent sequence for the same seed, e.g. one for every game or thread.
+     */
+    explicit constexpr Random(uint64_t seed, uint64_t stream = 0) {
+        auto value = seed ^ splitmix64(stream);
+        for (auto& word : state) {
+            word = splitmix64(value);
+        }
+    }
+
+    /**
+     * @return The next 64 random bits.
+     */
+    constexpr uint64_t next() {
+        auto result = rotate_left(state[1] * 5, 7) * 9;
+        auto shifted = state[1] << 17;
+
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= shifted;
+        state[3] = rotate_left(state[3], 45);
+
+        return result;
+    }
+
+    /**
+     * Gets an evenly distributed number, without the bias of next() % bound.
+     * @param bound The number of possible values, greater than 0.
+     * @return A number from 0 to bound - 1.
+     */
+    constexpr uint64_t below(uint64_t bound) {
+        // the numbers at the end of the range that would make some results more likely are skipped
+        auto limit = std::numeric_limits<uint64_t>::max() - std::numeric_limits<uint64_t>::max() % bound;
+        auto value = next();
+        while (value >= limit) {
+            value = next();
+        }
+        return value % bound;
+    }
+
+    constexpr uint64_t operator()() {
+        return next();
+    }
+
+    static constexpr uint64_t min() {
+        return 0;
+    }
+
+    static constexpr uint64_t max() {
+        return std::numeric_limits<uint64_t>::max();
+    }
+};
@@ -0,0 +1,754 @@
+#include "Search.hpp"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include "../movegen/MoveGen.hpp"
+#include "../eval/Evaluation.hpp"
+#include "../hash/Zobrist.hpp"
+#include "../tablebase/Tablebases.hpp"
+#include "../stats/Stats.hpp"
+
+namespace {
+    constexpr int TT_MOVE_SCORE = 1'000'000;
+    constexpr int CAPTURE_SCORE = 100'000;
+    constexpr int KILLER_SCORE = 90'000;
+    constexpr int HISTORY_MAX = 16'384;
+
+    constexpr int REVERSE_FUTILITY_DEPTH = 3;
+    constexpr int REVERSE_FUTILITY_MARGIN = 120;
+    constexpr int FUTILITY_DEPTH = 2;
+    constexpr int FUTILITY_MARGINS[FUTILITY_DEPTH + 1] = {0, 200, 450};
+    constexpr int NULL_MOVE_VERIFICATION_DEPTH = 8;
+
+    // late move reductions grow with the depth and the number of moves already searched
+    struct ReductionTable {
+        int values[MAX_PLY][MoveList::CAPACITY]{};
+
+        ReductionTable() {
+            for (int depth = 1; depth < MAX_PLY; ++depth) {
+                for (int count = 1; count < MoveList::CAPACITY; ++count) {
+                    values[depth][count] = static_cast<int>(0.75 + std::log(depth) * std::log(count) / 2.25);
+                }
+            }
+        }
+    };
+
+    const ReductionTable REDUCTIONS;
+
+    // keeps the hash of a position on the history while its moves are searched
+    class HistoryScope {
+        PositionHistory& history;
+    public:
+        HistoryScope(PositionHistory& history, uint64_t key) : history(history) {
+            history.push(key);
+        }
+        ~HistoryScope() {
+            history.pop();
+        }
+    };
+
+    int square_index(Position position) {
+        return position.get_x() * 8 + position.get_y();
+    }
+}
+
+// *****************************************************
+// Public Methods
+// *****************************************************
+
+Search::Search(SearchOptions options, size_t hash_mb) : tt(hash_mb), options(options) {}
+
+/**
+ * Searches the best move with iterative deepening until one of the limits is reached.
+ * @param board The gameboard, oriented for the player to move.
+ * @param side_to_move The color of the player to move.
+ * @param search_limits The limits of the search.
+ * @param game_history The positions of the game before the current one, to detect repetitions.
+ * @param progress Called with the result after every completed iteration.
+ * @return The best move of the deepest completed iteration.
+ *         The move is invalid if there is no legal move.
+ */
+SearchResult Search::think(const GameBoard& board, Color side_to_move, const SearchLimits& search_limits,
+                           const PositionHistory& game_history, const ProgressCallback& progress) {
+    stop_signal = false;
+    pondering = search_limits.ponder;
+
+    return run(board, side_to_move, search_limits, game_history, progress);
+}
+
+/**
+ * Starts the search in another thread, the search is stopped by cancelling the handle or with stop.
+ * The board and the history are copied, so they can be changed while the search is running.
+ * The search object must not be used for anything else until the result is available.
+ * @param progress Called on the search thread with the result after every completed iteration.
+ * @return The handle of the search, it waits for the search when it is destroyed.
+ */
+SearchHandle Search::think_async(const GameBoard& board, Color side_to_move, const SearchLimits& search_limits,
+                                 const PositionHistory& game_history, ProgressCallback progress) {
+    stop_signal = false;
+    pondering = search_limits.ponder;
+
+    auto task = std::make_shared<SearchTask>();
+
+    std::thread([this, task, root = GameBoard{board}, side_to_move, search_limits, game_history, progress = std::move(progress)]() {
+        SearchResult result;
+        std::exception_ptr error;
+
+        try {
+            std::stop_callback on_cancel(task->stop_source.get_token(), [this]() { stop(); });
+            result = run(root, side_to_move, search_limits, game_history, progress);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        // the search object is not touched anymore, the owner of the handle may destroy it now
+        task->finish(result, error);
+    }).detach();
+
+    return SearchHandle{task};
+}
+
+/**
+ * Stops a running search as soon as possible, the best move found so far is returned.
+ * A stopped ponder search has searched the wrong position, so its result should be ignored.
+ */
+void Search::stop() {
+    stop_signal = true;
+}
+
+/**
+ * The opponent played the expected move, so the ponder search continues as a normal search.
+ * The node and time limits start now.
+ */
+void Search::ponder_hit() {
+    pondering = false;
+}
+
+/**
+ * Forgets everything learned in previous searches, used when a new game starts.
+ */
+void Search::clear() {
+    tt.clear();
+
+    for (auto& color : history) {
+        for (auto& from : color) {
+            std::fill(std::begin(from), std::end(from), 0);
+        }
+    }
+}
+
+// *****************************************************
+// Private Methods
+// *****************************************************
+
+/**
+ * Runs the search in the calling thread, the stop and ponder flags are set by the caller.
+ */
+SearchResult Search::run(const GameBoard& board, Color side_to_move, const SearchLimits& search_limits,
+                         const PositionHistory& game_history, const ProgressCallback& progress) {
+    STATS_TIMER(SEARCH);
+
+    limits = search_limits;
+    path = game_history;
+    start_time = std::chrono::steady_clock::now();
+    nodes = 0;
+    stopped = false;
+
+    for (auto& killer : killers) {
+        killer[0] = Move{};
+        killer[1] = Move{};
+    }
+
+    SearchResult result;
+    auto root = GameBoard{board};
+
+    root_moves.clear();
+    MoveGen::generate_legal(root, side_to_move, root_moves);
+
+    if (root_moves.empty()) {
+        return result;
+    }
+
+    // with few pieces left the tablebases know the result of every move.
+    // a won position the fifty move rule cannot draw is played with the move closest to the next capture or pawn move,
+    // otherwise only the moves keeping the best result are searched
+    auto wdl = WDL_DRAW;
+    if (options.tablebases && Tablebases::root_probe(root, side_to_move, root_moves, wdl) && wdl == WDL_WIN) {
+        result.best_move = root_moves[0];
+        result.score = TB_WIN_SCORE;
+        result.lines.push_back({TB_WIN_SCORE, 0, {result.best_move}});
+        return result;
+    }
+
+    // there is always a move to play, even if the first iteration does not finish
+    result.best_move = root_moves[0];
+
+    // the lines share the transposition table, so every line after the first
+    // finds most of its positions already searched by the lines before
+    auto multi_pv = std::clamp(limits.multi_pv, 1, root_moves.size());
+
+    for (int depth = 1; depth <= limits.depth && depth < MAX_PLY; ++depth) {
+        std::vector<PvLine> lines;
+
+        for (pv_index = 0; pv_index < multi_pv; ++pv_index) {
+            root_best_move = Move{};
+            auto score = negamax(root, side_to_move, depth, -INFINITE_SCORE, INFINITE_SCORE, 0, false);
+
+            if (stopped) {
+                break;
+            }
+
+            // the best move of the line is left out of the following lines
+            auto best_move = root_best_move.is_valid() ? root_best_move : root_moves[pv_index];
+            std::swap(*std::find(root_moves.begin() + pv_index, root_moves.end(), best_move), root_moves[pv_index]);
+            lines.push_back({score, depth, {best_move}});
+        }
+
+        pv_index = 0;
+        if (stopped) {
+            break;
+        }
+
+        // a later line can score better than an earlier one, when the earlier one was cut short by the table.
+        // the next iteration searches the lines in the new order
+        std::stable_sort(lines.begin(), lines.end(), [](const PvLine& a, const PvLine& b) { return a.score > b.score; });
+        for (int i = 0; i < multi_pv; ++i) {
+            auto line_index = static_cast<size_t>(i);
+            root_moves[i] = lines[line_index].moves[0];
+            lines[line_index].moves = find_pv(root, side_to_move, root_moves[i], depth);
+        }
+
+        result.best_move = lines[0].moves[0];
+        result.score = lines[0].score;
+        result.depth = depth;
+        result.nodes = nodes;
+        result.lines = std::move(lines);
+
+        if (progress) {
+            progress(result);
+        }
+
+        // a found mate will not get any better, the other lines still can
+        if (multi_pv == 1 && std::abs(result.score) >= MATE_BOUND) {
+            break;
+        }
+    }
+
+    auto pv = find_pv(root, side_to_move, result.best_move, 2);
+
+    result.nodes = nodes;
+    result.ponder_move = pv.size() > 1 ? pv[1] : Move{};
+    return result;
+}
+
+
+/**
+ * Principal variation search of a position.
+ * @param board The gameboard, oriented for the player to move.
+ * @param us The color of the player to move.
+ * @param depth The remaining depth.
+ * @param alpha The lower bound of the window.
+ * @param beta The upper bound of the window.
+ * @param ply The distance to the root.
+ * @param null_allowed false directly after a null move.
+ * @return The score from the perspective of the player to move.
+ */
+int Search::negamax(GameBoard& board, Color us, int depth, int alpha, int beta, int ply, bool null_allowed) {
+    if (depth <= 0) {
+        return quiescence(board, us, alpha, beta, ply);
+    }
+
+    ++nodes;
+    STATS_INC(NODES);
+    check_limits();
+    if (stopped) {
+        return 0;
+    }
+
+    auto enemy = enemy_of(us);
+    auto in_check = MoveGen::in_check(board, us);
+
+    if (ply >= MAX_PLY - 1) {
+        return in_check ? 0 : Evaluation::evaluate(board, us);
+    }
+
+    auto key = Zobrist::hash(board, us);
+
+    // a repetition inside the search is scored as a draw right away,
+    // if it is good for one side, it can be repeated again
+    if (ply > 0 &&
+        (board.get_halfmove_clock() >= 100 ||
+         path.repetitions(key, board.get_halfmove_clock()) > 0 ||
+         board.has_insufficient_material())) {
+        return 0;
+    }
+
+    // the tablebases are only probed directly after a capture or a pawn move,
+    // then the position is new and the fifty move rule does not matter yet
+    int tb_score;
+    if (ply > 0 && options.tablebases && board.get_halfmove_clock() == 0 && probe_tablebases(board, us, ply, tb_score)) {
+        tt.store(key, TranspositionTable::score_to_tt(tb_score, ply), Move{}, std::min(depth + 6, MAX_PLY - 1), Bound::EXACT);
+        return tb_score;
+    }
+
+    auto pv_node = beta - alpha > 1;
+    auto tt_entry = tt.probe(key);
+    Move tt_move;
+
+    if (tt_entry) {
+        STATS_INC(TT_HITS);
+        tt_move = Move::from_packed(tt_entry->move);
+
+        if (!pv_node && tt_entry->depth >= depth) {
+            auto tt_score = TranspositionTable::score_from_tt(tt_entry->score, ply);
+
+            if (tt_entry->bound == Bound::EXACT ||
+                (tt_entry->bound == Bound::LOWER && tt_score >= beta) ||
+                (tt_entry->bound == Bound::UPPER && tt_score <= alpha)) {
+                return tt_score;
+            }
+        }
+    } else {
+        STATS_INC(TT_MISSES);
+    }
+
+    auto static_eval = in_check ? -INFINITE_SCORE : Evaluation::evaluate(board, us);
+
+    if (!pv_node && !in_check) {
+        // reverse futility pruning
+        // if we are far above beta near the leaves, the opponent will not let us get here
+        if (options.reverse_futility &&
+            depth <= REVERSE_FUTILITY_DEPTH &&
+            std::abs(beta) < TB_WIN_BOUND &&
+            static_eval - REVERSE_FUTILITY_MARGIN * depth >= beta) {
+            return static_eval;
+        }
+
+        // null move pruning
+        // if passing the turn still fails high, a real move will most likely fail high as well.
+        // this is wrong in zugzwang, so it is not done with only pawns left,
+        // and deep searches verify the cutoff with a reduced search without null moves
+        if (options.null_move &&
+            null_allowed &&
+            depth >= 3 &&
+            static_eval >= beta &&
+            Evaluation::has_non_pawn_material(board, us)) {
+            auto reduction = 2 + depth / 4;
+
+            auto child = GameBoard{board};
+            child.make_null_move();
+            child.flip();
+
+            int score;
+            {
+                auto null_move_scope = HistoryScope{path, key};
+                score = -negamax(child, enemy, depth - 1 - reduction, -beta, -beta + 1, ply + 1, false);
+            }
+            if (stopped) {
+                return 0;
+            }
+
+            if (score >= beta) {
+                // do not trust mate scores of the null move
+                score = std::min(score, TB_WIN_BOUND - 1);
+
+                if (depth < NULL_MOVE_VERIFICATION_DEPTH) {
+                    return score;
+                }
+
+                // the verification searches this position again and adds it to the path itself,
+                // the path has to be the same as on entry, or the repetitions below are counted on the wrong plies
+                auto verified = negamax(board, us, depth - 1 - reduction, beta - 1, beta, ply, false);
+                if (verified >= beta) {
+                    return score;
+                }
+            }
+        }
+    }
+
+    auto history_scope = HistoryScope{path, key};
+
+    MoveList moves;
+    if (ply == 0) {
+        // the best moves of the lines already searched in this iteration are left out
+        for (int i = pv_index; i < root_moves.size(); ++i) {
+            moves.push_back(root_moves[i]);
+        }
+    } else {
+        // in check the generator only creates the moves that may end the check, all others are illegal anyway
+        MoveGen::generate_legal(board, us, moves, in_check ? GenType::EVASIONS : GenType::ALL);
+    }
+
+    if (moves.empty()) {
+        return in_check ? -MATE_SCORE + ply : 0;
+    }
+
+    int scores[MoveList::CAPACITY];
+    score_moves(board, us, moves, tt_move, ply, scores);
+
+    // futility pruning
+    // quiet moves near the leaves can not bring a position far below alpha back
+    auto futility_pruning = options.futility &&
+                            !pv_node &&
+                            !in_check &&
+                            depth <= FUTILITY_DEPTH &&
+                            std::abs(alpha) < TB_WIN_BOUND &&
+                            static_eval + FUTILITY_MARGINS[depth] <= alpha;
+
+    auto original_alpha = alpha;
+    auto best_score = -INFINITE_SCORE;
+    Move best_move;
+    int searched = 0;
+
+    for (int i = 0; i < moves.size(); ++i) {
+        auto move = pick_move(moves, scores, i);
+        auto quiet = !MoveGen::is_capture(board, move) && move.get_promotion() == ' ';
+
+        auto child = GameBoard{board};
+        child.make_move(move);
+        child.flip();
+
+        auto gives_check = MoveGen::in_check(child, enemy);
+
+        if (futility_pruning && quiet && !gives_check && searched > 0) {
+            continue;
+        }
+
+        auto extension = (options.check_extensions && gives_check) ? 1 : 0;
+        auto new_depth = depth - 1 + extension;
+        int score;
+
+        if (searched == 0) {
+            score = -negamax(child, enemy, new_depth, -beta, -alpha, ply + 1, true);
+        } else {
+            int reduction = 0;
+
+            // late move reductions
+            // quiet moves late in the move ordering are searched with less depth,
+            // moves with a good history are reduced less, moves with a bad history more
+            if (options.late_move_reductions &&
+                depth >= 3 &&
+                searched >= 3 &&
+                quiet &&
+                !in_check &&
+                !gives_check &&
+                !is_killer(move, ply)) {
+                reduction = REDUCTIONS.values[depth][std::min(searched, MoveList::CAPACITY - 1)];
+                reduction -= history_of(us, move) / (HISTORY_MAX / 2);
+                reduction += pv_node ? 0 : 1;
+                reduction = std::clamp(reduction, 0, new_depth - 1);
+            }
+
+            score = -negamax(child, enemy, new_depth - reduction, -alpha - 1, -alpha, ply + 1, true);
+
+            if (score > alpha && reduction > 0) {
+                score = -negamax(child, enemy, new_depth, -alpha - 1, -alpha, ply + 1, true);
+            }
+
+            if (score > alpha && score < beta) {
+                score = -negamax(child, enemy, new_depth, -beta, -alpha, ply + 1, true);
+            }
+        }
+
+        ++searched;
+
+        if (stopped) {
+            return 0;
+        }
+
+        if (score > best_score) {
+            best_score = score;
+            best_move = move;
+
+            if (ply == 0) {
+                root_best_move = move;
+            }
+
+            if (score > alpha) {
+                alpha = score;
+
+                if (alpha >= beta) {
+                    STATS_INC(BETA_CUTOFFS);
+                    if (quiet) {
+                        update_quiet_stats(board, us, move, moves, i, depth, ply);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    auto bound = (best_score >= beta) ? Bound::LOWER :
+                 (best_score > original_alpha) ? Bound::EXACT : Bound::UPPER;
+    // the root without the moves of the earlier lines is not the real position
+    if (ply > 0 || pv_index == 0) {
+        tt.store(key, TranspositionTable::score_to_tt(best_score, ply), best_move, depth, bound);
+    }
+
+    return best_score;
+}
+
+/**
+ * Searches only captures and promotions until the position is quiet,
+ * so the static evaluation is not done in the middle of an exchange.
+ * A player in check cannot stand pat, all evasions are searched and without one the position is mate.
+ */
+int Search::quiescence(GameBoard& board, Color us, int alpha, int beta, int ply) {
+    ++nodes;
+    STATS_INC(QUIESCENCE_NODES);
+    check_limits();
+    if (stopped) {
+        return 0;
+    }
+
+    auto in_check = MoveGen::in_check(board, us);
+
+    if (ply >= MAX_PLY - 1) {
+        return in_check ? 0 : Evaluation::evaluate(board, us);
+    }
+
+    if (!in_check) {
+        auto stand_pat = Evaluation::evaluate(board, us);
+        if (stand_pat >= beta) {
+            return stand_pat;
+        }
+
+        alpha = std::max(alpha, stand_pat);
+    }
+
+    // in check every evasion, otherwise only captures and promotions to a queen
+    MoveList moves;
+    MoveGen::generate_legal(board, us, moves, in_check ? GenType::EVASIONS : GenType::CAPTURES);
+
+    if (in_check && moves.empty()) {
+        return -MATE_SCORE + ply;
+    }
+
+    int scores[MoveList::CAPACITY];
+    score_moves(board, us, moves, Move{}, ply, scores);
+
+    auto enemy = enemy_of(us);
+
+    for (int i = 0; i < moves.size(); ++i) {
+        auto move = pick_move(moves, scores, i);
+
+        auto child = GameBoard{board};
+        child.make_move(move);
+        child.flip();
+
+        auto score = -quiescence(child, enemy, -beta, -alpha, ply + 1);
+
+        if (stopped) {
+            return 0;
+        }
+
+        if (score > alpha) {
+            alpha = score;
+            if (alpha >= beta) {
+                break;
+            }
+        }
+    }
+
+    return alpha;
+}
+
+/**
+ * Probes the win/draw/loss tablebases.
+ * Wins are scored below the mate scores, so a real mate is still preferred.
+ * Cursed wins and blessed losses are draws by the fifty move rule.
+ * @param score Set to the score of the position from the perspective of the player to move.
+ * @return true if the position was found in the tablebases.
+ */
+bool Search::probe_tablebases(GameBoard& board, Color us, int ply, int& score) {
+    if (!Tablebases::can_probe(board)) {
+        return false;
+    }
+
+    ProbeState state;
+    auto wdl = Tablebases::probe_wdl(board, us, state);
+
+    if (state == PROBE_FAIL) {
+        return false;
+    }
+
+    STATS_INC(TB_HITS);
+    score = (wdl == WDL_WIN) ? TB_WIN_SCORE - ply :
+            (wdl == WDL_LOSS) ? -TB_WIN_SCORE + ply : 0;
+    return true;
+}
+
+/**
+ * Follows the moves of the transposition table, starting with the given move.
+ * @param max_length The most moves of the line.
+ * @return The line, it ends early at a position the table does not know or at a repetition.
+ */
+std::vector<Move> Search::find_pv(const GameBoard& board, Color side_to_move, const Move& first_move, int max_length) const {
+    std::vector<Move> pv;
+    if (!first_move.is_valid()) {
+        return pv;
+    }
+
+    auto position = GameBoard{board};
+    auto us = side_to_move;
+    auto move = first_move;
+    std::vector<uint64_t> keys;
+
+    while (true) {
+        pv.push_back(move);
+        position.make_move(move);
+        position.flip();
+        us = enemy_of(us);
+
+        if (static_cast<int>(pv.size()) >= max_length) {
+            break;
+        }
+
+        auto key = Zobrist::hash(position, us);
+        if (std::find(keys.begin(), keys.end(), key) != keys.end()) {
+            break;
+        }
+        keys.push_back(key);
+
+        auto tt_entry = tt.probe(key);
+        if (!tt_entry) {
+            break;
+        }
+
+        move = Move::from_packed(tt_entry->move);
+
+        MoveList moves;
+        MoveGen::generate_legal(position, us, moves);
+        if (!moves.contains(move)) {
+            break;
+        }
+    }
+
+    return pv;
+}
+
+/**
+ * Scores the moves for the move ordering.
+ * The move from the transposition table first, then captures with the most valuable victim
+ * and the least valuable attacker, then the killer moves and all other quiet moves by their history.
+ */
+void Search::score_moves(const GameBoard& board, Color us, const MoveList& moves, const Move& tt_move, int ply, int (&scores)[MoveList::CAPACITY]) const {
+    for (int i = 0; i < moves.size(); ++i) {
+        const auto& move = moves[i];
+
+        if (move == tt_move) {
+            scores[i] = TT_MOVE_SCORE;
+            continue;
+        }
+
+        auto attacker = board.get_piece(move.get_from());
+        auto victim = board.get_piece(move.get_to());
+
+        if (MoveGen::is_capture(board, move) || move.get_promotion() != ' ') {
+            // en passant captures a pawn on another field
+            auto victim_value = victim ? Evaluation::piece_value(victim->get_name()) : Evaluation::piece_value('P');
+            victim_value += Evaluation::piece_value(move.get_promotion());
+            scores[i] = CAPTURE_SCORE + victim_value * 10 - Evaluation::piece_value(attacker->get_name()) / 10;
+        } else if (move == killers[ply][0] || move == killers[ply][1]) {
+            scores[i] = KILLER_SCORE;
+        } else {
+            const auto& from = move.get_from();
+            const auto& to = move.get_to();
+            scores[i] = history[static_cast<int>(us)][square_index(from)][square_index(to)];
+        }
+    }
+}
+
+/**
+ * Selects the best scored move of the remaining moves and swaps it to the given index.
+ * Cheaper than sorting, as most nodes only look at the first few moves.
+ */
+Move Search::pick_move(MoveList& moves, int (&scores)[MoveList::CAPACITY], int index) {
+    auto best = index;
+
+    for (int i = index + 1; i < moves.size(); ++i) {
+        if (scores[i] > scores[best]) {
+            best = i;
+        }
+    }
+
+    std::swap(moves[index], moves[best]);
+    std::swap(scores[index], scores[best]);
+
+    return moves[index];
+}
+
+/**
+ * Rewards the quiet move that caused a beta cutoff and punishes the quiet moves searched before it.
+ * @param board The gameboard of the position.
+ * @param us The color of the player to move.
+ * @param move The move that caused the cutoff.
+ * @param moves The moves of the position, ordered up to the index of the cutoff move.
+ * @param searched The index of the cutoff move.
+ * @param depth The remaining depth.
+ * @param ply The distance to the root.
+ */
+void Search::update_quiet_stats(const GameBoard& board, Color us, const Move& move, const MoveList& moves, int searched, int depth, int ply) {
+    if (!(killers[ply][0] == move)) {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = move;
+    }
+
+    // the bonus gets smaller the closer the history is to its maximum
+    auto bonus = std::min(depth * depth, HISTORY_MAX / 16);
+    auto update = [&](const Move& m, int value) {
+        auto& entry = history_of(us, m);
+        entry += value - entry * std::abs(value) / HISTORY_MAX;
+    };
+
+    update(move, bonus);
+
+    for (int i = 0; i < searched; ++i) {
+        if (moves[i].get_promotion() == ' ' && !MoveGen::is_capture(board, moves[i])) {
+            update(moves[i], -bonus);
+        }
+    }
+}
+
+int& Search::history_of(Color us, const Move& move) {
+    return history[static_cast<int>(us)][square_index(move.get_from())][square_index(move.get_to())];
+}
+
+bool Search::is_killer(const Move& move, int ply) const {
+    return move == killers[ply][0] || move == killers[ply][1];
+}
+
+/**
+ * Stops the search if the node or the time limit is reached.
+ * The clock is only read every 1024 nodes.
+ */
+void Search::check_limits() {
+    if (stop_signal.load(std::memory_order_relaxed)) {
+        stopped = true;
+        return;
+    }
+
+    // the opponent has not moved yet, so there is no reason to stop
+    if (limits.ponder) {
+        if (pondering.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        limits.ponder = false;
+        limits.nodes += limits.nodes ? nodes : 0;
+        start_time = std::chrono::steady_clock::now();
+    }
+
+    if (limits.nodes && nodes >= limits.nodes) {
+        stopped = true;
+    }
+
+    if (limits.time_ms && (nodes & 1023) == 0) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start_time).count();
+
+        if (elapsed >= limits.time_ms) {
+            stopped = true;
+        }
+    }
+}
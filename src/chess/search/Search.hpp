@@ -0,0 +1,100 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "../gameboard/GameBoard.hpp"
+#include "../color/Color.hpp"
+#include "../position/Move.hpp"
+#include "../position/PositionHistory.hpp"
+#include "../movegen/MoveList.hpp"
+#include "TranspositionTable.hpp"
+#include "SearchHandle.hpp"
+
+constexpr int MAX_PLY = 128;
+constexpr int MATE_SCORE = 32000;
+constexpr int MATE_BOUND = MATE_SCORE - MAX_PLY;
+constexpr int TB_WIN_SCORE = MATE_BOUND - MAX_PLY;
+constexpr int TB_WIN_BOUND = TB_WIN_SCORE - MAX_PLY;
+constexpr int INFINITE_SCORE = 32001;
+
+// limits of a single search, a value of 0 means no limit
+// a ponder search ignores the node and time limits until ponder_hit is called, they start from then on
+struct SearchLimits {
+    int depth{MAX_PLY - 1};
+    uint64_t nodes{0};
+    int64_t time_ms{0};
+    bool ponder{false};
+    int multi_pv{1}; // the number of best lines, every iteration searches them one after another
+};
+
+// selective search features, each of them can be switched off for benchmarking
+struct SearchOptions {
+    bool null_move{true};
+    bool late_move_reductions{true};
+    bool reverse_futility{true};
+    bool futility{true};
+    bool check_extensions{true};
+    bool tablebases{true};
+};
+
+// alpha beta search with iterative deepening
+// the board is copied for every move, as GameBoard has no way to undo a move.
+// the search uses no randomness, without a time limit its result only depends on the position, the limits
+// and the tables kept from earlier searches, so after clear() the same search always gives the same result
+class Search {
+    TranspositionTable tt;
+    SearchOptions options;
+    SearchLimits limits;
+    std::chrono::steady_clock::time_point start_time;
+    uint64_t nodes{0};
+    bool stopped{false};
+
+    // set by other threads while a search is running
+    std::atomic<bool> stop_signal{false};
+    std::atomic<bool> pondering{false};
+
+    // the positions of the game before the root, followed by the positions of the current line
+    PositionHistory path;
+
+    MoveList root_moves;
+    Move root_best_move;
+    int pv_index{0}; // the root moves before it are the best moves of the lines already searched in this iteration
+
+    // history of quiet moves that caused a beta cutoff, indexed by color, from and to field
+    int history[2][64][64]{};
+    Move killers[MAX_PLY][2];
+
+    SearchResult run(const GameBoard& board, Color side_to_move, const SearchLimits& search_limits,
+                     const PositionHistory& game_history, const ProgressCallback& progress);
+    int negamax(GameBoard& board, Color us, int depth, int alpha, int beta, int ply, bool null_allowed);
+    int quiescence(GameBoard& board, Color us, int alpha, int beta, int ply);
+    bool probe_tablebases(GameBoard& board, Color us, int ply, int& score);
+    std::vector<Move> find_pv(const GameBoard& board, Color side_to_move, const Move& first_move, int max_length) const;
+
+    void score_moves(const GameBoard& board, Color us, const MoveList& moves, const Move& tt_move, int ply, int (&scores)[MoveList::CAPACITY]) const;
+    static Move pick_move(MoveList& moves, int (&scores)[MoveList::CAPACITY], int index);
+    void update_quiet_stats(const GameBoard& board, Color us, const Move& move, const MoveList& moves, int searched, int depth, int ply);
+    [[nodiscard]] int& history_of(Color us, const Move& move);
+    [[nodiscard]] bool is_killer(const Move& move, int ply) const;
+    void check_limits();
+
+public:
+    explicit Search(SearchOptions options = {}, size_t hash_mb = 16);
+    ~Search() = default;
+
+    SearchResult think(const GameBoard& board, Color side_to_move, const SearchLimits& search_limits,
+                       const PositionHistory& game_history = PositionHistory{}, const ProgressCallback& progress = {});
+    SearchHandle think_async(const GameBoard& board, Color side_to_move, const SearchLimits& search_limits,
+                             const PositionHistory& game_history = PositionHistory{}, ProgressCallback progress = {});
+    void stop();
+    void ponder_hit();
+    void clear();
+
+    void set_options(const SearchOptions& search_options) {
+        options = search_options;
+    }
+
+    [[nodiscard]] const SearchOptions& get_options() const {
+        return options;
+    }
+};
@@ -0,0 +1,96 @@
+#include "SearchHandle.hpp"
+#include <utility>
+
+/**
+ * Publishes the result and wakes everyone waiting for it.
+ * @param search_result The result of the search.
+ * @param search_error The exception thrown by the search, if there was one.
+ */
+void SearchTask::finish(const SearchResult& search_result, std::exception_ptr search_error) {
+    std::coroutine_handle<> waiting;
+    {
+        std::lock_guard lock(mutex);
+        result = search_result;
+        error = std::move(search_error);
+        finished = true;
+        waiting = std::exchange(continuation, nullptr);
+    }
+    finished_signal.notify_all();
+
+    if (waiting) {
+        waiting.resume();
+    }
+}
+
+// *****************************************************
+// Public Methods
+// *****************************************************
+
+SearchHandle& SearchHandle::operator=(SearchHandle&& other) noexcept {
+    if (this != &other) {
+        cancel();
+        if (task) {
+            std::unique_lock lock(task->mutex);
+            task->finished_signal.wait(lock, [this]() { return task->finished; });
+        }
+        task = std::move(other.task);
+    }
+    return *this;
+}
+
+SearchHandle::~SearchHandle() {
+    if (!task) {
+        return;
+    }
+
+    cancel();
+    std::unique_lock lock(task->mutex);
+    task->finished_signal.wait(lock, [this]() { return task->finished; });
+}
+
+/**
+ * Stops the search as soon as possible, it still finishes with the best move found so far.
+ */
+void SearchHandle::cancel() {
+    if (task) {
+        task->stop_source.request_stop();
+    }
+}
+
+/**
+ * @return true if the search is finished, get returns without waiting then.
+ */
+bool SearchHandle::is_ready() const {
+    std::lock_guard lock(task->mutex);
+    return task->finished;
+}
+
+/**
+ * Waits for the search to finish and takes its result, the handle is invalid afterwards.
+ * @throws The exception of the search, if it failed.
+ */
+SearchResult SearchHandle::get() {
+    auto finished_task = std::move(task);
+
+    std::unique_lock lock(finished_task->mutex);
+    finished_task->finished_signal.wait(lock, [&]() { return finished_task->finished; });
+
+    if (finished_task->error) {
+        std::rethrow_exception(finished_task->error);
+    }
+    return finished_task->result;
+}
+
+/**
+ * Lets the coroutine wait for the result, it is resumed on the search thread.
+ * @return false if the search is already finished, the coroutine continues right away then.
+ */
+bool SearchHandle::await_suspend(std::coroutine_handle<> continuation) {
+    std::lock_guard lock(task->mutex);
+    if (task->finished) {
+        return false;
+    }
+
+    task->continuation = continuation;
+    return true;
+}
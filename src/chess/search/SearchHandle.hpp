@@ -0,0 +1,91 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <vector>
+#include "../position/Move.hpp"
+
+// one of the best lines of a search
+struct PvLine {
+    int score{0};
+    int depth{0};
+    std::vector<Move> moves; // the move of the root, followed by the expected continuation
+};
+
+struct SearchResult {
+    Move best_move;
+    Move ponder_move; // the expected reply to the best move
+    int score{0};
+    int depth{0};
+    uint64_t nodes{0};
+    std::vector<PvLine> lines; // the best lines of the last completed iteration, the best first
+};
+
+// called on the search thread after every completed iteration, with the result so far
+using ProgressCallback = std::function<void(const SearchResult&)>;
+
+// the state shared by a running search and its handle
+struct SearchTask {
+    std::mutex mutex;
+    std::condition_variable finished_signal;
+    bool finished{false};
+    SearchResult result;
+    std::exception_ptr error;
+    std::coroutine_handle<> continuation; // a coroutine waiting for the result
+    std::stop_source stop_source;
+
+    void finish(const SearchResult& search_result, std::exception_ptr search_error);
+};
+
+// a search running on its own thread, see Search::think_async.
+// the result can be waited for, polled, or awaited with co_await in a coroutine, which is resumed on the search thread.
+// a handle that is destroyed before the search finished cancels it and waits for it,
+// so the search object is never used after the handle is gone
+class SearchHandle {
+    std::shared_ptr<SearchTask> task;
+
+public:
+    SearchHandle() = default;
+    explicit SearchHandle(std::shared_ptr<SearchTask> task) : task(std::move(task)) {}
+    SearchHandle(SearchHandle&& other) noexcept = default;
+    SearchHandle& operator=(SearchHandle&& other) noexcept;
+    SearchHandle(const SearchHandle&) = delete;
+    SearchHandle& operator=(const SearchHandle&) = delete;
+    ~SearchHandle();
+
+    /**
+     * @return true if the handle belongs to a search whose result was not taken yet.
+     */
+    [[nodiscard]] bool valid() const {
+        return task != nullptr;
+    }
+
+    void cancel();
+    [[nodiscard]] bool is_ready() const;
+    SearchResult get();
+
+    /**
+     * Waits for the search to finish, at most for the given time.
+     * @return true if the result is available.
+     */
+    template<typename Rep, typename Period>
+    bool wait_for(const std::chrono::duration<Rep, Period>& timeout) const {
+        std::unique_lock lock(task->mutex);
+        return task->finished_signal.wait_for(lock, timeout, [this]() { return task->finished; });
+    }
+
+    [[nodiscard]] bool await_ready() const {
+        return is_ready();
+    }
+
+    bool await_suspend(std::coroutine_handle<> continuation);
+
+    SearchResult await_resume() {
+        return get();
+    }
+};
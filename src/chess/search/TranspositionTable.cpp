@@ -0,0 +1,80 @@
+#include "TranspositionTable.hpp"
+#include "Search.hpp"
+
+TranspositionTable::TranspositionTable(size_t size_mb) {
+    resize(size_mb);
+}
+
+/**
+ * Resizes the table to the largest power of two number of entries that fits into the given size.
+ * All stored entries are lost.
+ * @param size_mb The size of the table in megabytes.
+ */
+void TranspositionTable::resize(size_t size_mb) {
+    auto bytes = std::max<size_t>(size_mb, 1) * 1024 * 1024;
+    size_t count = 1;
+
+    while (count * 2 * sizeof(TTEntry) <= bytes) {
+        count *= 2;
+    }
+
+    entries.assign(count, TTEntry{});
+    mask = count - 1;
+}
+
+void TranspositionTable::clear() {
+    std::fill(entries.begin(), entries.end(), TTEntry{});
+}
+
+/**
+ * Looks up the entry of the position.
+ * @param key The zobrist hash of the position.
+ * @return The entry, or nullptr if the position is not stored.
+ */
+const TTEntry* TranspositionTable::probe(uint64_t key) const {
+    const auto& entry = entries[key & mask];
+    return (entry.bound != Bound::NONE && entry.key == key) ? &entry : nullptr;
+}
+
+/**
+ * Stores the result of a search.
+ * A deeper result of the same position is only replaced by a result of at least similar depth.
+ * @param key The zobrist hash of the position.
+ * @param score The score, already adjusted with score_to_tt.
+ * @param move The best move found, can be invalid.
+ * @param depth The remaining depth of the search.
+ * @param bound Whether the score is exact, a lower or an upper bound.
+ */
+void TranspositionTable::store(uint64_t key, int score, Move move, int depth, Bound bound) {
+    auto& entry = entries[key & mask];
+
+    if (entry.key == key && entry.depth > depth + 2 && bound != Bound::EXACT) {
+        return;
+    }
+
+    // keep the old best move if the new search did not find one
+    if (move.is_valid() || entry.key != key) {
+        entry.move = move.to_packed();
+    }
+
+    entry.key = key;
+    entry.score = score;
+    entry.depth = static_cast<int8_t>(depth);
+    entry.bound = bound;
+}
+
+/**
+ * Mate and tablebase scores are stored relative to the position instead of the root,
+ * so they stay correct when the position is found at another ply.
+ */
+int TranspositionTable::score_to_tt(int score, int ply) {
+    if (score >= TB_WIN_BOUND) return score + ply;
+    if (score <= -TB_WIN_BOUND) return score - ply;
+    return score;
+}
+
+int TranspositionTable::score_from_tt(int score, int ply) {
+    if (score >= TB_WIN_BOUND) return score - ply;
+    if (score <= -TB_WIN_BOUND) return score + ply;
+    return score;
+}
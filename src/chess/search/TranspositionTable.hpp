@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "../position/Move.hpp"
+
+enum class Bound : uint8_t {
+    NONE,
+    EXACT,
+    LOWER,
+    UPPER
+};
+
+// single entry of the transposition table, 16 bytes
+struct TTEntry {
+    uint64_t key{0};
+    int32_t score{0};
+    uint16_t move{0};
+    int8_t depth{0};
+    Bound bound{Bound::NONE};
+};
+
+// hash table that stores the results of already searched positions
+// the table is indexed with the zobrist hash of the position
+class TranspositionTable {
+    std::vector<TTEntry> entries;
+    uint64_t mask{0};
+
+public:
+    explicit TranspositionTable(size_t size_mb);
+    ~TranspositionTable() = default;
+
+    void resize(size_t size_mb);
+    void clear();
+
+    [[nodiscard]] const TTEntry* probe(uint64_t key) const;
+    void store(uint64_t key, int score, Move move, int depth, Bound bound);
+
+    [[nodiscard]] static int score_to_tt(int score, int ply);
+    [[nodiscard]] static int score_from_tt(int score, int ply);
+};
@@ -0,0 +1,120 @@
+#include "Stats.hpp"
+#include <atomic>
+#include <sstream>
+
+namespace {
+    // the search can run in another thread while pondering, so the values are atomic
+    std::atomic<uint64_t> counters[COUNTER_COUNT];
+    std::atomic<uint64_t> timer_ns[TIMER_COUNT];
+    std::atomic<uint64_t> timer_calls[TIMER_COUNT];
+
+    constexpr const char* COUNTER_NAMES[COUNTER_COUNT] = {
+        "nodes",
+        "quiescence_nodes",
+        "legal_checks",
+        "board_copies",
+        "allocations",
+        "tt_hits",
+        "tt_misses",
+        "beta_cutoffs",
+        "tb_hits"
+    };
+
+    constexpr const char* TIMER_NAMES[TIMER_COUNT] = {
+        "search",
+        "move_generation",
+        "legality",
+        "check_detection",
+        "evaluation",
+        "has_moves_left"
+    };
+}
+
+// *****************************************************
+// Public Methods
+// *****************************************************
+
+void Stats::add(Counter counter, uint64_t value) {
+    counters[static_cast<size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+}
+
+void Stats::add_time(Timer timer, uint64_t ns) {
+    timer_ns[static_cast<size_t>(timer)].fetch_add(ns, std::memory_order_relaxed);
+    timer_calls[static_cast<size_t>(timer)].fetch_add(1, std::memory_order_relaxed);
+}
+
+StatsSnapshot Stats::snapshot() {
+    StatsSnapshot result;
+
+    for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+        result.counters[i] = counters[i].load(std::memory_order_relaxed);
+    }
+
+    for (size_t i = 0; i < TIMER_COUNT; ++i) {
+        result.timer_ns[i] = timer_ns[i].load(std::memory_order_relaxed);
+        result.timer_calls[i] = timer_calls[i].load(std::memory_order_relaxed);
+    }
+
+    return result;
+}
+
+void Stats::reset() {
+    for (auto& counter : counters) {
+        counter = 0;
+    }
+
+    for (size_t i = 0; i < TIMER_COUNT; ++i) {
+        timer_ns[i] = 0;
+        timer_calls[i] = 0;
+    }
+}
+
+StatsSnapshot StatsSnapshot::operator-(const StatsSnapshot& other) const {
+    StatsSnapshot result;
+
+    for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+        result.counters[i] = counters[i] - other.counters[i];
+    }
+
+    for (size_t i = 0; i < TIMER_COUNT; ++i) {
+        result.timer_ns[i] = timer_ns[i] - other.timer_ns[i];
+        result.timer_calls[i] = timer_calls[i] - other.timer_calls[i];
+    }
+
+    return result;
+}
+
+StatsSnapshot& StatsSnapshot::operator+=(const StatsSnapshot& other) {
+    for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+        counters[i] += other.counters[i];
+    }
+
+    for (size_t i = 0; i < TIMER_COUNT; ++i) {
+        timer_ns[i] += other.timer_ns[i];
+        timer_calls[i] += other.timer_calls[i];
+    }
+
+    return *this;
+}
+
+/**
+ * Formats the statistics as a json object, the times are in microseconds.
+ */
+std::string StatsSnapshot::to_json() const {
+    std::ostringstream out;
+    out << "{\"counters\": {";
+
+    for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+        out << (i ? ", " : "") << "\"" << COUNTER_NAMES[i] << "\": " << counters[i];
+    }
+
+    out << "}, \"timers\": {";
+
+    for (size_t i = 0; i < TIMER_COUNT; ++i) {
+        out << (i ? ", " : "") << "\"" << TIMER_NAMES[i] << "\": {\"us\": " << timer_ns[i] / 1000
+            << ", \"calls\": " << timer_calls[i] << "}";
+    }
+
+    out << "}}";
+    return out.str();
+}
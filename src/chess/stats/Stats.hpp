@@ -0,0 +1,91 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// counters and timers of the hot paths, only compiled in with the cmake option CHESS_STATS.
+// without it the macros below expand to nothing, so the instrumentation costs nothing
+
+enum class Counter {
+    NODES,            // nodes of the alpha beta search
+    QUIESCENCE_NODES, // nodes of the quiescence search
+    LEGAL_CHECKS,     // moves checked for leaving the own king in check
+    BOARD_COPIES,
+    ALLOCATIONS,      // pieces created, they come from the piece pool
+    TT_HITS,
+    TT_MISSES,
+    BETA_CUTOFFS,
+    TB_HITS,
+    COUNT
+};
+
+// timers are inclusive, the time of validate_moves also contains the time of is_king_in_check
+enum class Timer {
+    SEARCH,
+    MOVE_GENERATION,
+    LEGALITY,
+    CHECK_DETECTION,
+    EVALUATION,
+    HAS_MOVES_LEFT,
+    COUNT
+};
+
+constexpr auto COUNTER_COUNT = static_cast<size_t>(Counter::COUNT);
+constexpr auto TIMER_COUNT = static_cast<size_t>(Timer::COUNT);
+
+// the values of all counters and timers at one point in time,
+// the difference of two snapshots are the statistics of everything in between
+struct StatsSnapshot {
+    uint64_t counters[COUNTER_COUNT]{};
+    uint64_t timer_ns[TIMER_COUNT]{};
+    uint64_t timer_calls[TIMER_COUNT]{};
+
+    [[nodiscard]] uint64_t get(Counter counter) const {
+        return counters[static_cast<size_t>(counter)];
+    }
+
+    StatsSnapshot operator-(const StatsSnapshot& other) const;
+    StatsSnapshot& operator+=(const StatsSnapshot& other);
+
+    [[nodiscard]] std::string to_json() const;
+};
+
+class Stats {
+public:
+#ifdef CHESS_STATS
+    static constexpr bool ENABLED = true;
+#else
+    static constexpr bool ENABLED = false;
+#endif
+
+    static void add(Counter counter, uint64_t value);
+    static void add_time(Timer timer, uint64_t ns);
+
+    [[nodiscard]] static StatsSnapshot snapshot();
+    static void reset();
+};
+
+// adds the time until the end of the scope to the timer
+class ScopedTimer {
+    Timer timer;
+    std::chrono::steady_clock::time_point start;
+public:
+    explicit ScopedTimer(Timer timer) : timer(timer), start(std::chrono::steady_clock::now()) {}
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    ~ScopedTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        Stats::add_time(timer, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+};
+
+#ifdef CHESS_STATS
+#define STATS_ADD(counter, value) Stats::add(Counter::counter, static_cast<uint64_t>(value))
+#define STATS_TIMER(timer) ScopedTimer stats_timer_##timer{Timer::timer}
+#else
+#define STATS_ADD(counter, value) ((void) 0)
+#define STATS_TIMER(timer) ((void) 0)
+#endif
+
+#define STATS_INC(counter) STATS_ADD(counter, 1)
@@ -0,0 +1,219 @@
+#include "BinaryFile.hpp"
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    constexpr char MAGIC[8] = {'C', 'H', 'E', 'S', 'S', 'B', 'I', 'N'};
+    constexpr uint32_t VERSION = 1;
+    constexpr uint64_t ALIGNMENT = 8;
+}
+
+// *****************************************************
+// Public Methods
+// *****************************************************
+
+BinaryWriter::~BinaryWriter() {
+    close();
+}
+
+/**
+ * Creates the file, an existing file is overwritten.
+ * @param path The path of the file.
+ * @param file_kind If the file contains positions or games.
+ * @return true if the file could be created.
+ */
+bool BinaryWriter::open(const std::string& path, BinaryKind file_kind) {
+    close();
+
+    out.open(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Could not create " << path << std::endl;
+        return false;
+    }
+
+    kind = file_kind;
+    count = 0;
+    offset = sizeof(BinaryHeader);
+    game_offsets.clear();
+
+    // the header is written again with the count when the file is closed
+    write_header();
+    return true;
+}
+
+/**
+ * Writes the index of the games and the final header.
+ */
+void BinaryWriter::close() {
+    if (!out.is_open()) {
+        return;
+    }
+
+    if (kind == BinaryKind::GAMES) {
+        out.write(reinterpret_cast<const char*>(game_offsets.data()),
+                  static_cast<std::streamsize>(game_offsets.size() * sizeof(uint64_t)));
+    }
+
+    out.seekp(0);
+    write_header();
+    out.close();
+}
+
+void BinaryWriter::write(const PackedPosition& position) {
+    if (kind != BinaryKind::POSITIONS) {
+        throw std::logic_error("positions can only be written to a file of positions");
+    }
+
+    out.write(reinterpret_cast<const char*>(&position), sizeof(position));
+    offset += sizeof(position);
+    ++count;
+}
+
+/**
+ * Writes a game.
+ * @param start The start position, its result is the result of the game.
+ * @param moves The moves of the game, packed with pack_move.
+ */
+void BinaryWriter::write_game(const PackedPosition& start, std::span<const uint16_t> moves) {
+    if (kind != BinaryKind::GAMES) {
+        throw std::logic_error("games can only be written to a file of games");
+    }
+
+    GameRecord record{start, static_cast<uint32_t>(moves.size()), 0};
+    out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    out.write(reinterpret_cast<const char*>(moves.data()), static_cast<std::streamsize>(moves.size_bytes()));
+
+    // the next record has to be aligned for the 64 bit values of its position
+    auto length = sizeof(record) + moves.size_bytes();
+    auto padding = (ALIGNMENT - length % ALIGNMENT) % ALIGNMENT;
+    const char zeros[ALIGNMENT]{};
+    out.write(zeros, static_cast<std::streamsize>(padding));
+
+    game_offsets.push_back(offset);
+    offset += length + padding;
+    ++count;
+}
+
+BinaryReader::~BinaryReader() {
+    close();
+}
+
+/**
+ * Memory maps the file, a previously opened file is closed.
+ * @param path The path of the file.
+ * @return true if the file could be opened and its header is valid.
+ */
+bool BinaryReader::open(const std::string& path) {
+    close();
+
+    auto fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        std::cerr << "Could not open " << path << std::endl;
+        return false;
+    }
+
+    struct stat statbuf{};
+    fstat(fd, &statbuf);
+    auto file_size = static_cast<size_t>(statbuf.st_size);
+
+    if (file_size < sizeof(BinaryHeader)) {
+        std::cerr << "Invalid binary file " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    auto address = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (address == MAP_FAILED) {
+        std::cerr << "Could not map " << path << std::endl;
+        return false;
+    }
+
+    data = static_cast<const uint8_t*>(address);
+    size = file_size;
+
+    // the records have to fit into the file, so they can be read without further checks
+    const auto& file_header = header();
+    auto valid = std::memcmp(file_header.magic, MAGIC, sizeof(MAGIC)) == 0 && file_header.version == VERSION;
+
+    if (valid && file_header.kind == BinaryKind::POSITIONS) {
+        valid = file_header.count <= (size - sizeof(BinaryHeader)) / sizeof(PackedPosition);
+    } else if (valid && file_header.kind == BinaryKind::GAMES) {
+        valid = file_header.index_offset % ALIGNMENT == 0 && file_header.index_offset <= size &&
+                file_header.count <= (size - file_header.index_offset) / sizeof(uint64_t);
+    } else {
+        valid = false;
+    }
+
+    if (!valid) {
+        std::cerr << "Invalid binary file " << path << std::endl;
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void BinaryReader::close() {
+    if (data) {
+        munmap(const_cast<uint8_t*>(data), size);
+    }
+    data = nullptr;
+    size = 0;
+}
+
+/**
+ * @return All positions of a file of positions, empty for a file of games.
+ */
+std::span<const PackedPosition> BinaryReader::positions() const {
+    if (kind() != BinaryKind::POSITIONS) {
+        return {};
+    }
+    return {reinterpret_cast<const PackedPosition*>(data + sizeof(BinaryHeader)), count()};
+}
+
+/**
+ * Gets a game of a file of games.
+ * @param index The number of the game, starting with 0.
+ * @throws std::out_of_range if there is no such game or its record is not inside the file.
+ */
+GameView BinaryReader::game(size_t index) const {
+    if (kind() != BinaryKind::GAMES || index >= count()) {
+        throw std::out_of_range("no game " + std::to_string(index));
+    }
+
+    auto offsets = reinterpret_cast<const uint64_t*>(data + header().index_offset);
+    auto offset = offsets[index];
+
+    if (offset % ALIGNMENT != 0 || offset < sizeof(BinaryHeader) || offset + sizeof(GameRecord) > header().index_offset) {
+        throw std::out_of_range("invalid offset of game " + std::to_string(index));
+    }
+
+    auto record = reinterpret_cast<const GameRecord*>(data + offset);
+    if (offset + sizeof(GameRecord) + uint64_t{record->move_count} * sizeof(uint16_t) > header().index_offset) {
+        throw std::out_of_range("invalid length of game " + std::to_string(index));
+    }
+
+    return {record->start, {reinterpret_cast<const uint16_t*>(record + 1), record->move_count}};
+}
+
+// *****************************************************
+// Private Methods
+// *****************************************************
+
+void BinaryWriter::write_header() {
+    BinaryHeader file_header{};
+    std::memcpy(file_header.magic, MAGIC, sizeof(MAGIC));
+    file_header.version = VERSION;
+    file_header.kind = kind;
+    file_header.count = count;
+    file_header.index_offset = (kind == BinaryKind::GAMES) ? offset : 0;
+
+    out.write(reinterpret_cast<const char*>(&file_header), sizeof(file_header));
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+#include "PackedPosition.hpp"
+
+// binary files of positions or games, several times smaller and faster to read than FEN or PGN.
+//
+// the file starts with a header, followed by the records:
+//   positions: an array of PackedPosition
+//   games: for every game a GameRecord followed by its moves as 16 bit values (see pack_move),
+//          padded to a multiple of 8 bytes, and at the end the offsets of all games as an index
+// all records are aligned, so the reader uses the memory mapped file directly without copying
+
+enum class BinaryKind : uint32_t {
+    POSITIONS = 1,
+    GAMES = 2
+};
+
+struct BinaryHeader {
+    char magic[8];
+    uint32_t version;
+    BinaryKind kind;
+    uint64_t count;
+    uint64_t index_offset; // offset of the index of the games, 0 for positions
+};
+
+static_assert(sizeof(BinaryHeader) == 32, "the header has to be 32 bytes");
+
+// the result of the game is the result of the start position
+struct GameRecord {
+    PackedPosition start;
+    uint32_t move_count;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(GameRecord) == 40, "a game record has to be 40 bytes");
+
+struct GameView {
+    const PackedPosition& start;
+    std::span<const uint16_t> moves;
+};
+
+class BinaryWriter {
+    std::ofstream out;
+    BinaryKind kind{BinaryKind::POSITIONS};
+    uint64_t count{0};
+    uint64_t offset{0};
+    std::vector<uint64_t> game_offsets;
+
+    void write_header();
+
+public:
+    BinaryWriter() = default;
+    BinaryWriter(const BinaryWriter&) = delete;
+    BinaryWriter& operator=(const BinaryWriter&) = delete;
+    ~BinaryWriter();
+
+    bool open(const std::string& path, BinaryKind file_kind);
+    void close();
+
+    [[nodiscard]] bool is_open() const {
+        return out.is_open();
+    }
+
+    void write(const PackedPosition& position);
+    void write_game(const PackedPosition& start, std::span<const uint16_t> moves);
+};
+
+class BinaryReader {
+    const uint8_t* data{nullptr};
+    size_t size{0};
+
+    [[nodiscard]] const BinaryHeader& header() const {
+        return *reinterpret_cast<const BinaryHeader*>(data);
+    }
+
+public:
+    BinaryReader() = default;
+    BinaryReader(const BinaryReader&) = delete;
+    BinaryReader& operator=(const BinaryReader&) = delete;
+    ~BinaryReader();
+
+    bool open(const std::string& path);
+    void close();
+
+    [[nodiscard]] bool is_open() const {
+        return data != nullptr;
+    }
+
+    [[nodiscard]] BinaryKind kind() const {
+        return header().kind;
+    }
+
+    [[nodiscard]] size_t count() const {
+        return static_cast<size_t>(header().count);
+    }
+
+    [[nodiscard]] std::span<const PackedPosition> positions() const;
+    [[nodiscard]] GameView game(size_t index) const;
+};
@@ -0,0 +1,161 @@
+#include "PackedPosition.hpp"
+#include "../fen/Fen.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    // index of the symbol is the 4 bit code of the piece, the unused codes are invalid
+    constexpr char PIECE_SYMBOLS[16] = {'?', 'P', 'N', 'B', 'R', 'Q', 'K', '?', '?', 'p', 'n', 'b', 'r', 'q', 'k', '?'};
+
+    uint8_t piece_code(ChessPiece& piece) {
+        uint8_t code;
+        switch (piece.get_name()) {
+            case 'P': code = 1; break;
+            case 'N': code = 2; break;
+            case 'B': code = 3; break;
+            case 'R': code = 4; break;
+            case 'Q': code = 5; break;
+            default: code = 6; break;
+        }
+        return (piece.get_color() == Color::BLACK) ? static_cast<uint8_t>(code | 8) : code;
+    }
+
+    int castling_right(bool white, CastlingSide side) {
+        return white ? ((side == KING_SIDE) ? WHITE_KING_SIDE : WHITE_QUEEN_SIDE)
+                     : ((side == KING_SIDE) ? BLACK_KING_SIDE : BLACK_QUEEN_SIDE);
+    }
+
+    /**
+     * Marks the castling rooks that are not the outermost rook on their side of the king.
+     * @return The INNER_ROOK bits of the flags.
+     */
+    uint8_t inner_rooks(const GameBoard& board) {
+        uint8_t result = 0;
+
+        for (auto side : {QUEEN_SIDE, KING_SIDE}) {
+            auto rook_file = board.get_castling_file(side);
+            auto step = (side == KING_SIDE) ? -1 : 1;
+
+            for (auto white : {true, false}) {
+                if (!(board.get_castling_rights() & castling_right(white, side))) {
+                    continue;
+                }
+
+                auto home_rank = white ? 0 : 7;
+                for (auto file = (side == KING_SIDE) ? 7 : 0; file != rook_file; file += step) {
+                    auto piece = board.get_piece(board.absolute({home_rank, file}));
+                    if (piece && piece->get_name() == 'R' && (piece->get_color() == Color::WHITE) == white) {
+                        result = static_cast<uint8_t>(result | PackedPosition::INNER_ROOK[side]);
+                    }
+                }
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Finds the rook next to the king on one side, for a player that may castle to that side.
+     * @return The file of the rook, -1 if there is none.
+     */
+    int inner_rook_file(const char (&pieces)[8][8], int rights, CastlingSide side) {
+        for (auto white : {true, false}) {
+            if (!(rights & castling_right(white, side))) {
+                continue;
+            }
+
+            const auto& home_rank = pieces[white ? 0 : 7];
+            auto king = std::find(std::begin(home_rank), std::end(home_rank), white ? 'K' : 'k');
+            if (king == std::end(home_rank)) {
+                continue;
+            }
+
+            auto step = (side == KING_SIDE) ? 1 : -1;
+            for (auto file = static_cast<int>(king - std::begin(home_rank)) + step; file >= 0 && file < 8; file += step) {
+                if (home_rank[file] == (white ? 'R' : 'r')) {
+                    return file;
+                }
+            }
+        }
+
+        return -1;
+    }
+}
+
+// *****************************************************
+// Public Methods
+// *****************************************************
+
+/**
+ * Packs the position of the gameboard.
+ * @param board The gameboard, in any orientation.
+ * @param side_to_move The color of the player to move.
+ * @param fullmove_number The number of the move, the board does not know it.
+ */
+PackedPosition PackedPosition::pack(const GameBoard& board, Color side_to_move, int fullmove_number) {
+    PackedPosition result;
+    size_t count = 0;
+
+    for (int square = 0; square < 64; ++square) {
+        auto piece = board.get_piece(board.absolute({square / 8, square % 8}));
+        if (!piece) {
+            continue;
+        }
+
+        // a position has at most 32 pieces, as every piece is a king, a pawn or a piece that a pawn promoted to
+        if (count == 32) {
+            throw std::invalid_argument("too many pieces to pack the position");
+        }
+
+        result.occupancy |= uint64_t{1} << square;
+        result.pieces[count / 2] |= static_cast<uint8_t>(piece_code(*piece) << ((count % 2) * 4));
+        ++count;
+    }
+
+    auto en_passant_file = board.get_en_passant_file(side_to_move);
+
+    result.flags = static_cast<uint8_t>((side_to_move == Color::BLACK ? 1 : 0) | (board.get_castling_rights() << 1));
+    if (board.is_chess960()) {
+        result.flags = static_cast<uint8_t>(result.flags | CHESS960 | inner_rooks(board));
+    }
+    result.en_passant_file = (en_passant_file >= 0) ? static_cast<uint8_t>(en_passant_file) : NO_EN_PASSANT;
+    result.halfmove_clock = static_cast<uint8_t>(std::min(board.get_halfmove_clock(), 255));
+    result.fullmove_number = static_cast<uint16_t>(fullmove_number);
+
+    return result;
+}
+
+/**
+ * Creates the gameboard of the position.
+ * @param side_to_move Set to the color of the player to move.
+ * @return The gameboard, oriented for the player to move.
+ * @throws std::invalid_argument if the data is not a valid position.
+ */
+GameBoard PackedPosition::unpack(Color& side_to_move) const {
+    char board[8][8];
+    size_t count = 0;
+
+    for (int square = 0; square < 64; ++square) {
+        auto symbol = ' ';
+
+        if (occupancy & (uint64_t{1} << square)) {
+            if (count == 32) {
+                throw std::invalid_argument("too many pieces in the packed position");
+            }
+            symbol = PIECE_SYMBOLS[(pieces[count / 2] >> ((count % 2) * 4)) & 15];
+            ++count;
+        }
+
+        board[square / 8][square % 8] = symbol;
+    }
+
+    side_to_move = this->side_to_move();
+    auto en_passant = (en_passant_file == NO_EN_PASSANT) ? -1 : static_cast<int>(en_passant_file);
+
+    auto rights = (flags >> 1) & 15;
+    auto queen_side_file = (flags & INNER_ROOK[QUEEN_SIDE]) ? inner_rook_file(board, rights, QUEEN_SIDE) : -1;
+    auto king_side_file = (flags & INNER_ROOK[KING_SIDE]) ? inner_rook_file(board, rights, KING_SIDE) : -1;
+
+    return Fen::create(board, side_to_move, rights, en_passant, halfmove_clock, queen_side_file, king_side_file,
+                       (flags & CHESS960) != 0);
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdint>
+#include "../gameboard/GameBoard.hpp"
+#include "../color/Color.hpp"
+#include "../position/Move.hpp"
+
+// a position in 32 bytes, for files with millions of positions.
+// the occupied fields are a bitboard in the absolute orientation (bit rank * 8 + file),
+// followed by 4 bits for each piece in the order of the bits.
+// the values are in the byte order of the machine, which is little endian on every supported platform
+struct PackedPosition {
+    uint64_t occupancy{0};
+    uint8_t pieces[16]{};
+    int16_t score{0};          // evaluation from the view of white, for training data
+    uint16_t fullmove_number{1};
+    uint8_t flags{0};          // bit 0 black to move, bits 1 to 4 the castling rights, bits 5 to 7 see below
+    uint8_t en_passant_file{NO_EN_PASSANT};
+    uint8_t halfmove_clock{0};
+    int8_t result{0};          // result of the game from the view of white, 1 win, 0 draw, -1 loss
+
+    static constexpr uint8_t NO_EN_PASSANT = 0xFF;
+
+    // a chess960 board castles with the king taking its rook, even with the pieces on the standard fields.
+    // the castling rook of a side is the outermost rook of the player on that side of the king,
+    // unless another rook stands further outside, then it is marked as the rook next to the king
+    static constexpr uint8_t CHESS960 = 1 << 5;
+    static constexpr uint8_t INNER_ROOK[2] = {1 << 6, 1 << 7}; // by CastlingSide
+
+    [[nodiscard]] static PackedPosition pack(const GameBoard& board, Color side_to_move, int fullmove_number = 1);
+    [[nodiscard]] GameBoard unpack(Color& side_to_move) const;
+
+    [[nodiscard]] Color side_to_move() const {
+        return (flags & 1) ? Color::BLACK : Color::WHITE;
+    }
+};
+
+static_assert(sizeof(PackedPosition) == 32, "a packed position has to be 32 bytes");
+
+/**
+ * Packs a move into 16 bits in the absolute orientation, so it does not depend on the orientation of the board.
+ */
+[[nodiscard]] inline uint16_t pack_move(const GameBoard& board, const Move& move) {
+    return Move{board.absolute(move.get_from()), board.absolute(move.get_to()), move.get_promotion()}.to_packed();
+}
+
+/**
+ * Unpacks a move packed with pack_move for the current orientation of the board.
+ */
+[[nodiscard]] inline Move unpack_move(const GameBoard& board, uint16_t packed) {
+    auto move = Move::from_packed(packed);
+    if (!move.is_valid()) {
+        return move;
+    }
+    return {board.absolute(move.get_from()), board.absolute(move.get_to()), move.get_promotion()};
+}
@@ -0,0 +1,1371 @@
+/*
+  Syzygy tablebase probing, derived from the probing code of Stockfish
+  Copyright (C) 2004-2024 The Stockfish developers (see the AUTHORS file of Stockfish)
+  and from the original probing code of the Syzygy tablebases
+  Copyright (c) 2013-2018 Ronald de Man
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Tablebases.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../movegen/MoveGen.hpp"
+
+// the file format and the encoding of the positions follow the syzygy tablebase generator
+// by Ronald de Man, the layout of this code follows the probing code of Stockfish
+
+namespace {
+    constexpr int TB_PIECES = 7;
+
+    enum TBType {
+        WDL,
+        DTZ
+    };
+
+    // flags of the pairs data of a table
+    enum TBFlag {
+        STM = 1,
+        MAPPED = 2,
+        WIN_PLIES = 4,
+        LOSS_PLIES = 8,
+        WIDE = 16,
+        SINGLE_VALUE = 128
+    };
+
+    // flags of the first byte of a file
+    enum TBHeader {
+        SPLIT = 1,
+        HAS_PAWNS = 2
+    };
+
+    constexpr uint8_t WDL_MAGIC[4] = {0x71, 0xE8, 0x23, 0x5D};
+    constexpr uint8_t DTZ_MAGIC[4] = {0xD7, 0x66, 0x0C, 0xA5};
+
+    // pieces are encoded like in the tables: 1 to 6 for pawn to king, +8 for black
+    constexpr int PAWN = 1;
+    constexpr int KING = 6;
+    constexpr int BLACK_OFFSET = 8;
+
+    using Sym = uint16_t;
+
+    uint16_t read_le16(const uint8_t* data) {
+        return static_cast<uint16_t>(data[0] | (data[1] << 8));
+    }
+
+    uint32_t read_le32(const uint8_t* data) {
+        return static_cast<uint32_t>(data[0]) | static_cast<uint32_t>(data[1]) << 8 |
+               static_cast<uint32_t>(data[2]) << 16 | static_cast<uint32_t>(data[3]) << 24;
+    }
+
+    uint32_t read_be32(const uint8_t* data) {
+        return static_cast<uint32_t>(data[3]) | static_cast<uint32_t>(data[2]) << 8 |
+               static_cast<uint32_t>(data[1]) << 16 | static_cast<uint32_t>(data[0]) << 24;
+    }
+
+    uint64_t read_be64(const uint8_t* data) {
+        return static_cast<uint64_t>(read_be32(data)) << 32 | read_be32(data + 4);
+    }
+
+    int file_of(int square) {
+        return square & 7;
+    }
+
+    int rank_of(int square) {
+        return square >> 3;
+    }
+
+    int flip_file(int square) {
+        return square ^ 7;
+    }
+
+    int flip_rank(int square) {
+        return square ^ 56;
+    }
+
+    // distance of the square to the a1-h8 diagonal, negative below it
+    int off_a1h8(int square) {
+        return rank_of(square) - file_of(square);
+    }
+
+    int edge_distance(int file) {
+        return std::min(file, 7 - file);
+    }
+
+    // *****************************************************
+    // Encoding Tables
+    // *****************************************************
+
+    struct EncodingTables {
+        int map_b1h1h7[64]{};
+        int map_a1d1d4[64]{};
+        int map_kk[10][64]{};
+        uint64_t binomial[6][64]{};
+        int map_pawns[64]{};
+        uint64_t lead_pawn_idx[6][64]{};
+        uint64_t lead_pawns_size[6][4]{};
+
+        EncodingTables() {
+            // map_b1h1h7 encodes a square below the a1-h8 diagonal to 0..27
+            int code = 0;
+            for (int s = 0; s < 64; ++s) {
+                if (off_a1h8(s) < 0) {
+                    map_b1h1h7[s] = code++;
+                }
+            }
+
+            // map_a1d1d4 encodes a square in the a1-d1-d4 triangle to 0..9,
+            // the squares on the diagonal are encoded last
+            std::vector<int> diagonal;
+            code = 0;
+            for (int s = 0; s <= 27; ++s) {
+                if (off_a1h8(s) < 0 && file_of(s) <= 3) {
+                    map_a1d1d4[s] = code++;
+                } else if (!off_a1h8(s) && file_of(s) <= 3) {
+                    diagonal.push_back(s);
+                }
+            }
+            for (auto s : diagonal) {
+                map_a1d1d4[s] = code++;
+            }
+
+            // map_kk encodes the 462 legal positions of two kings, where the first one is in the a1-d1-d4 triangle.
+            // if the first king is on the diagonal, the second one may not be above it
+            std::vector<std::pair<int, int>> both_on_diagonal;
+            code = 0;
+            for (int idx = 0; idx < 10; ++idx) {
+                for (int s1 = 0; s1 <= 27; ++s1) {
+                    if (map_a1d1d4[s1] != idx || (idx == 0 && s1 != 1)) {
+                        continue;
+                    }
+
+                    for (int s2 = 0; s2 < 64; ++s2) {
+                        auto adjacent = std::abs(file_of(s1) - file_of(s2)) <= 1 && std::abs(rank_of(s1) - rank_of(s2)) <= 1;
+
+                        if (adjacent) {
+                            continue;
+                        } else if (!off_a1h8(s1) && off_a1h8(s2) > 0) {
+                            continue;
+                        } else if (!off_a1h8(s1) && !off_a1h8(s2)) {
+                            both_on_diagonal.emplace_back(idx, s2);
+                        } else {
+                            map_kk[idx][s2] = code++;
+                        }
+                    }
+                }
+            }
+            for (auto [idx, s2] : both_on_diagonal) {
+                map_kk[idx][s2] = code++;
+            }
+
+            // binomial[k][n] is the number of ways to choose k of n elements
+            binomial[0][0] = 1;
+            for (int n = 1; n < 64; ++n) {
+                for (int k = 0; k < 6 && k <= n; ++k) {
+                    binomial[k][n] = (k > 0 ? binomial[k - 1][n - 1] : 0) +
+                                     (k < n ? binomial[k][n - 1] : 0);
+                }
+            }
+
+            // map_pawns encodes the squares a2-h7 to 0..47, the leading pawn is the one with the highest value,
+            // the one nearest to the edge and with the lowest rank
+            int available_squares = 47;
+            for (int lead_pawns = 1; lead_pawns <= 5; ++lead_pawns) {
+                for (int f = 0; f <= 3; ++f) {
+                    uint64_t idx = 0;
+
+                    for (int r = 1; r <= 6; ++r) {
+                        auto s = r * 8 + f;
+
+                        if (lead_pawns == 1) {
+                            map_pawns[s] = available_squares--;
+                            map_pawns[flip_file(s)] = available_squares--;
+                        }
+
+                        lead_pawn_idx[lead_pawns][s] = idx;
+                        idx += binomial[lead_pawns - 1][map_pawns[s]];
+                    }
+
+                    lead_pawns_size[lead_pawns][f] = idx;
+                }
+            }
+        }
+    };
+
+    const EncodingTables TABLES;
+
+    // *****************************************************
+    // Table Data
+    // *****************************************************
+
+    // the first 12 bits are the left symbol, the second 12 bits the right symbol
+    struct LR {
+        uint8_t lr[3];
+
+        [[nodiscard]] Sym left() const {
+            return static_cast<Sym>(((lr[1] & 0xF) << 8) | lr[0]);
+        }
+
+        [[nodiscard]] Sym right() const {
+            return static_cast<Sym>((lr[2] << 4) | (lr[1] >> 4));
+        }
+    };
+
+    static_assert(sizeof(LR) == 3, "LR has to be packed");
+
+    // points to a known block and the offset of a value inside of it
+    struct SparseEntry {
+        uint8_t block[4];
+        uint8_t offset[2];
+    };
+
+    static_assert(sizeof(SparseEntry) == 6, "SparseEntry has to be packed");
+
+    // the compressed data of one table of a file, there is one per player to move and leading pawn file
+    struct PairsData {
+        uint8_t flags{0};
+        size_t size_of_block{0};
+        size_t span{0};
+        uint32_t blocks{0};
+        int max_sym_len{0};
+        int min_sym_len{0};
+        const uint8_t* lowest_sym{nullptr};
+        const LR* btree{nullptr};
+        const uint8_t* block_length{nullptr};
+        size_t block_length_size{0};
+        const SparseEntry* sparse_index{nullptr};
+        size_t sparse_index_size{0};
+        const uint8_t* data{nullptr};
+        std::vector<uint64_t> base64;
+        std::vector<uint8_t> symlen;
+        int pieces[TB_PIECES]{};
+        uint64_t group_idx[TB_PIECES + 1]{};
+        int group_len[TB_PIECES + 1]{};
+        uint16_t map_idx[4]{};
+    };
+
+    // one tablebase file, like KRvK.rtbw
+    struct TBTable {
+        TBType type;
+        std::string name;
+        uint64_t key{0};
+        uint64_t key2{0};
+        int piece_count{0};
+        bool has_pawns{false};
+        bool has_unique_pieces{false};
+        int pawn_count[2]{};
+        PairsData items[2][4];
+        const uint8_t* map{nullptr};
+
+        void* base_address{nullptr};
+        size_t mapping_size{0};
+        std::atomic<bool> ready{false};
+
+        TBTable(TBType type, std::string name) : type(type), name(std::move(name)) {}
+
+        [[nodiscard]] int sides() const {
+            return (type == WDL) ? 2 : 1;
+        }
+
+        PairsData* get(int stm, int file) {
+            return &items[stm % sides()][has_pawns ? file : 0];
+        }
+    };
+
+    // a piece on the board, converted to the encoding of the tables
+    struct TBPosition {
+        int squares[TB_PIECES]{};
+        int pieces[TB_PIECES]{};
+        int count{0};
+        int side_to_move{0};
+        uint64_t material_key{0};
+    };
+
+    // the material key packs the number of pieces of every type and color into 4 bits each
+    uint64_t material_key(const int (&counts)[2][7]) {
+        uint64_t key = 0;
+        for (int color = 0; color < 2; ++color) {
+            for (int type = PAWN; type <= KING; ++type) {
+                key |= static_cast<uint64_t>(counts[color][type]) << (4 * (color * 7 + type));
+            }
+        }
+        return key;
+    }
+
+    int piece_code(char name) {
+        return ChessPiece::get_type_index(name) + 1;
+    }
+
+    // *****************************************************
+    // Registry
+    // *****************************************************
+
+    std::vector<std::string> directories;
+    std::deque<TBTable> wdl_tables;
+    std::deque<TBTable> dtz_tables;
+    std::unordered_map<uint64_t, std::pair<TBTable*, TBTable*>> tables_by_key;
+    int largest_table = 0;
+    std::mutex mapping_mutex;
+
+    void clear_tables() {
+        for (auto* tables : {&wdl_tables, &dtz_tables}) {
+            for (auto& table : *tables) {
+                if (table.base_address) {
+                    munmap(table.base_address, table.mapping_size);
+                }
+            }
+        }
+
+        wdl_tables.clear();
+        dtz_tables.clear();
+        tables_by_key.clear();
+        largest_table = 0;
+    }
+
+    /**
+     * Registers the table of the given name, like KRvK.
+     * The table is found with the material key of both colors.
+     */
+    void add_table(const std::string& name) {
+        auto separator = name.find('v');
+        if (separator == std::string::npos) {
+            return;
+        }
+
+        int counts[2][7]{};
+        for (size_t i = 0; i < name.size(); ++i) {
+            if (i == separator) {
+                continue;
+            }
+            auto code = piece_code(name[i]);
+            if (code <= 0) {
+                return;
+            }
+            ++counts[i < separator ? 0 : 1][code];
+        }
+
+        int swapped[2][7]{};
+        std::copy(std::begin(counts[1]), std::end(counts[1]), std::begin(swapped[0]));
+        std::copy(std::begin(counts[0]), std::end(counts[0]), std::begin(swapped[1]));
+
+        auto key = material_key(counts);
+        if (tables_by_key.count(key)) {
+            return;
+        }
+
+        auto& wdl = wdl_tables.emplace_back(WDL, name);
+        auto& dtz = dtz_tables.emplace_back(DTZ, name);
+
+        for (auto* table : {&wdl, &dtz}) {
+            table->key = key;
+            table->key2 = material_key(swapped);
+            table->piece_count = static_cast<int>(name.size()) - 1;
+            table->has_pawns = counts[0][PAWN] || counts[1][PAWN];
+
+            for (const auto& side : counts) {
+                for (int type = PAWN; type < KING; ++type) {
+                    if (side[type] == 1) {
+                        table->has_unique_pieces = true;
+                    }
+                }
+            }
+
+            // the leading color is the one with less pawns, as this compresses better
+            auto white_leads = !counts[1][PAWN] || (counts[0][PAWN] && counts[1][PAWN] >= counts[0][PAWN]);
+            table->pawn_count[0] = white_leads ? counts[0][PAWN] : counts[1][PAWN];
+            table->pawn_count[1] = white_leads ? counts[1][PAWN] : counts[0][PAWN];
+        }
+
+        tables_by_key[wdl.key] = {&wdl, &dtz};
+        tables_by_key[wdl.key2] = {&wdl, &dtz};
+        largest_table = std::max(largest_table, wdl.piece_count);
+    }
+
+    // *****************************************************
+    // File Mapping
+    // *****************************************************
+
+    /**
+     * Memory maps the file of the table from the first directory that contains it.
+     * @return The data after the magic bytes, or nullptr if the file is missing or corrupt.
+     */
+    const uint8_t* map_file(TBTable& table, const std::string& file_name) {
+        for (const auto& directory : directories) {
+            auto path = (std::filesystem::path(directory) / file_name).string();
+            auto fd = open(path.c_str(), O_RDONLY);
+            if (fd == -1) {
+                continue;
+            }
+
+            struct stat statbuf{};
+            fstat(fd, &statbuf);
+
+            // every table file is a multiple of 64 bytes plus the 16 byte header
+            if (statbuf.st_size % 64 != 16) {
+                std::cerr << "Corrupt tablebase file " << path << std::endl;
+                close(fd);
+                return nullptr;
+            }
+
+            auto size = static_cast<size_t>(statbuf.st_size);
+            auto address = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+            close(fd);
+
+            if (address == MAP_FAILED) {
+                std::cerr << "Could not map tablebase file " << path << std::endl;
+                return nullptr;
+            }
+
+            // probes jump around the whole file, read ahead does not help
+            madvise(address, size, MADV_RANDOM);
+
+            auto data = static_cast<const uint8_t*>(address);
+            const auto& magic = (table.type == WDL) ? WDL_MAGIC : DTZ_MAGIC;
+
+            if (std::memcmp(data, magic, 4) != 0) {
+                std::cerr << "Corrupt tablebase file " << path << std::endl;
+                munmap(address, size);
+                return nullptr;
+            }
+
+            table.base_address = address;
+            table.mapping_size = size;
+            return data + 4;
+        }
+
+        return nullptr;
+    }
+
+    // *****************************************************
+    // Table Setup
+    // *****************************************************
+
+    /**
+     * Computes the number of pieces in every group and the start index of every group.
+     * The pieces of a group are the same piece, the leading group are the leading pawns,
+     * or the kings and one more unique piece.
+     */
+    void set_groups(TBTable& table, PairsData* d, const int (&order)[2], int file) {
+        int n = 0;
+        int first_len = table.has_pawns ? 0 : table.has_unique_pieces ? 3 : 2;
+        d->group_len[n] = 1;
+
+        for (int i = 1; i < table.piece_count; ++i) {
+            if (--first_len > 0 || d->pieces[i] != d->pieces[i - 1]) {
+                d->group_len[++n] = 1;
+            } else {
+                d->group_len[n]++;
+            }
+        }
+
+        d->group_len[++n] = 0;
+
+        // the order in which the groups are encoded is stored in the table,
+        // the leading group is at order[0] and the remaining pawns, if both colors have pawns, at order[1]
+        auto both_pawns = table.has_pawns && table.pawn_count[1];
+        int next = both_pawns ? 2 : 1;
+        int free_squares = 64 - d->group_len[0] - (both_pawns ? d->group_len[1] : 0);
+        uint64_t idx = 1;
+
+        for (int k = 0; next < n || k == order[0] || k == order[1]; ++k) {
+            if (k == order[0]) {
+                d->group_idx[0] = idx;
+                idx *= table.has_pawns ? TABLES.lead_pawns_size[d->group_len[0]][file]
+                                       : table.has_unique_pieces ? 31332 : 462;
+            } else if (k == order[1]) {
+                d->group_idx[1] = idx;
+                idx *= TABLES.binomial[d->group_len[1]][48 - d->group_len[0]];
+            } else {
+                d->group_idx[next] = idx;
+                idx *= TABLES.binomial[d->group_len[next]][free_squares];
+                free_squares -= d->group_len[next++];
+            }
+        }
+
+        d->group_idx[n] = idx;
+    }
+
+    /**
+     * Computes the number of values every huffman symbol expands to.
+     */
+    int set_symlen(PairsData* d, Sym s, std::vector<bool>& visited) {
+        visited[s] = true;
+
+        auto right = d->btree[s].right();
+        if (right == 0xFFF) {
+            return 0;
+        }
+
+        auto left = d->btree[s].left();
+
+        if (!visited[left]) {
+            d->symlen[left] = static_cast<uint8_t>(set_symlen(d, left, visited));
+        }
+        if (!visited[right]) {
+            d->symlen[right] = static_cast<uint8_t>(set_symlen(d, right, visited));
+        }
+
+        return d->symlen[left] + d->symlen[right] + 1;
+    }
+
+    /**
+     * Reads the sizes of the compressed data and sets up the canonical huffman decoding.
+     * @return The data after the size information.
+     */
+    const uint8_t* set_sizes(PairsData* d, const uint8_t* data) {
+        d->flags = *data++;
+
+        // all positions of the table have the same value, which is stored right here
+        if (d->flags & SINGLE_VALUE) {
+            d->blocks = 0;
+            d->block_length_size = 0;
+            d->span = 0;
+            d->sparse_index_size = 0;
+            d->min_sym_len = *data++;
+            return data;
+        }
+
+        // the last group index is the size of the table
+        auto groups = std::find(d->group_len, d->group_len + TB_PIECES, 0) - d->group_len;
+        auto tb_size = d->group_idx[groups];
+
+        d->size_of_block = size_t{1} << *data++;
+        d->span = size_t{1} << *data++;
+        d->sparse_index_size = static_cast<size_t>((tb_size + d->span - 1) / d->span);
+        auto padding = *data++;
+        d->blocks = read_le32(data);
+        data += 4;
+        d->block_length_size = d->blocks + padding;
+        d->max_sym_len = *data++;
+        d->min_sym_len = *data++;
+        d->lowest_sym = data;
+        d->base64.resize(static_cast<size_t>(d->max_sym_len - d->min_sym_len + 1));
+
+        // longer codes of the canonical huffman code have lower values,
+        // base64[i] is the lowest code of length i + min_sym_len, padded to 64 bits
+        for (auto i = static_cast<int>(d->base64.size()) - 2; i >= 0; --i) {
+            auto index = static_cast<size_t>(i);
+            d->base64[index] = (d->base64[index + 1] + read_le16(d->lowest_sym + 2 * index) -
+                                read_le16(d->lowest_sym + 2 * (index + 1))) / 2;
+        }
+
+        for (size_t i = 0; i < d->base64.size(); ++i) {
+            d->base64[i] <<= 64 - i - static_cast<size_t>(d->min_sym_len);
+        }
+
+        data += d->base64.size() * sizeof(Sym);
+        d->symlen.resize(read_le16(data));
+        data += sizeof(uint16_t);
+        d->btree = reinterpret_cast<const LR*>(data);
+
+        // symbols are created by recursive pairing, each symbol expands to a left and a right symbol
+        std::vector<bool> visited(d->symlen.size());
+        for (size_t sym = 0; sym < d->symlen.size(); ++sym) {
+            if (!visited[sym]) {
+                d->symlen[sym] = static_cast<uint8_t>(set_symlen(d, static_cast<Sym>(sym), visited));
+            }
+        }
+
+        return data + d->symlen.size() * sizeof(LR) + (d->symlen.size() & 1);
+    }
+
+    /**
+     * Reads the maps of the dtz tables, they translate the stored values into distances.
+     */
+    const uint8_t* set_dtz_map(TBTable& table, const uint8_t* data, int max_file) {
+        if (table.type == WDL) {
+            return data;
+        }
+
+        table.map = data;
+
+        for (int f = 0; f <= max_file; ++f) {
+            auto d = table.get(0, f);
+            if (!(d->flags & MAPPED)) {
+                continue;
+            }
+
+            if (d->flags & WIDE) {
+                data += reinterpret_cast<uintptr_t>(data) & 1;
+                for (auto& idx : d->map_idx) {
+                    idx = static_cast<uint16_t>((data - table.map) / 2 + 1);
+                    data += 2 * read_le16(data) + 2;
+                }
+            } else {
+                for (auto& idx : d->map_idx) {
+                    idx = static_cast<uint16_t>(data - table.map + 1);
+                    data += *data + 1;
+                }
+            }
+        }
+
+        return data + (reinterpret_cast<uintptr_t>(data) & 1);
+    }
+
+    /**
+     * Reads the header of the table and sets up the pointers into the mapped file.
+     * @param table The table.
+     * @param data The mapped data after the magic bytes.
+     */
+    void set_table(TBTable& table, const uint8_t* data) {
+        auto header = *data++;
+        if (table.has_pawns != bool(header & HAS_PAWNS) || (table.key != table.key2) != bool(header & SPLIT)) {
+            std::cerr << "Tablebase file " << table.name << " does not match its name" << std::endl;
+        }
+
+        auto sides = (table.type == WDL && table.key != table.key2) ? 2 : 1;
+        auto max_file = table.has_pawns ? 3 : 0;
+        auto both_pawns = table.has_pawns && table.pawn_count[1];
+
+        for (int f = 0; f <= max_file; ++f) {
+            for (int i = 0; i < sides; ++i) {
+                *table.get(i, f) = PairsData();
+            }
+
+            int order[2][2] = {
+                {*data & 0xF, both_pawns ? *(data + 1) & 0xF : 0xF},
+                {*data >> 4, both_pawns ? *(data + 1) >> 4 : 0xF}
+            };
+            data += 1 + both_pawns;
+
+            for (int k = 0; k < table.piece_count; ++k, ++data) {
+                for (int i = 0; i < sides; ++i) {
+                    table.get(i, f)->pieces[k] = i ? *data >> 4 : *data & 0xF;
+                }
+            }
+
+            for (int i = 0; i < sides; ++i) {
+                set_groups(table, table.get(i, f), order[i], f);
+            }
+        }
+
+        data += reinterpret_cast<uintptr_t>(data) & 1;
+
+        for (int f = 0; f <= max_file; ++f) {
+            for (int i = 0; i < sides; ++i) {
+                data = set_sizes(table.get(i, f), data);
+            }
+        }
+
+        data = set_dtz_map(table, data, max_file);
+
+        for (int f = 0; f <= max_file; ++f) {
+            for (int i = 0; i < sides; ++i) {
+                auto d = table.get(i, f);
+                d->sparse_index = reinterpret_cast<const SparseEntry*>(data);
+                data += d->sparse_index_size * sizeof(SparseEntry);
+            }
+        }
+
+        for (int f = 0; f <= max_file; ++f) {
+            for (int i = 0; i < sides; ++i) {
+                auto d = table.get(i, f);
+                d->block_length = data;
+                data += d->block_length_size * sizeof(uint16_t);
+            }
+        }
+
+        for (int f = 0; f <= max_file; ++f) {
+            for (int i = 0; i < sides; ++i) {
+                // the compressed data is aligned to 64 bytes
+                data = reinterpret_cast<const uint8_t*>((reinterpret_cast<uintptr_t>(data) + 0x3F) & ~uintptr_t{0x3F});
+                auto d = table.get(i, f);
+                d->data = data;
+                data += static_cast<size_t>(d->blocks) * d->size_of_block;
+            }
+        }
+    }
+
+    /**
+     * Maps the table on its first use, this is safe to call from multiple threads.
+     * @return true if the table is available.
+     */
+    bool mapped(TBTable& table) {
+        if (table.ready.load(std::memory_order_acquire)) {
+            return table.base_address != nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(mapping_mutex);
+        if (table.ready.load(std::memory_order_relaxed)) {
+            return table.base_address != nullptr;
+        }
+
+        auto file_name = table.name + ((table.type == WDL) ? ".rtbw" : ".rtbz");
+
+        auto data = map_file(table, file_name);
+        if (data) {
+            set_table(table, data);
+        }
+
+        table.ready.store(true, std::memory_order_release);
+        return table.base_address != nullptr;
+    }
+
+    // *****************************************************
+    // Decompression
+    // *****************************************************
+
+    /**
+     * Decompresses the value at the given index of the table.
+     * The values are stored in blocks of canonical huffman codes,
+     * every symbol expands into one or more values by recursive pairing.
+     */
+    int decompress_pairs(const PairsData* d, uint64_t idx) {
+        if (d->flags & SINGLE_VALUE) {
+            return d->min_sym_len;
+        }
+
+        // the sparse index points to a known value every span values,
+        // from there the blocks are walked until the block containing idx is found
+        auto k = static_cast<size_t>(idx / d->span);
+        auto block = read_le32(d->sparse_index[k].block);
+        int offset = read_le16(d->sparse_index[k].offset);
+
+        auto diff = static_cast<int>(idx % d->span) - static_cast<int>(d->span / 2);
+        offset += diff;
+
+        auto block_length = [d](uint32_t index) {
+            return static_cast<int>(read_le16(d->block_length + 2 * static_cast<size_t>(index)));
+        };
+
+        while (offset < 0) {
+            offset += block_length(--block) + 1;
+        }
+
+        while (offset > block_length(block)) {
+            offset -= block_length(block++) + 1;
+        }
+
+        auto ptr = d->data + static_cast<uint64_t>(block) * d->size_of_block;
+
+        // the first symbol of the block starts at the first bit
+        auto buf64 = read_be64(ptr);
+        ptr += 8;
+        int buf64_size = 64;
+        Sym sym;
+
+        while (true) {
+            size_t len = 0;
+
+            // find the length of the symbol, longer symbols have lower codes
+            while (buf64 < d->base64[len]) {
+                ++len;
+            }
+
+            // all symbols of the same length are consecutive
+            sym = static_cast<Sym>((buf64 - d->base64[len]) >> (64 - len - static_cast<size_t>(d->min_sym_len)));
+            sym = static_cast<Sym>(sym + read_le16(d->lowest_sym + 2 * len));
+
+            if (offset < d->symlen[sym] + 1) {
+                break;
+            }
+
+            offset -= d->symlen[sym] + 1;
+            len += static_cast<size_t>(d->min_sym_len);
+            buf64 <<= len;
+            buf64_size -= static_cast<int>(len);
+
+            if (buf64_size <= 32) {
+                buf64_size += 32;
+                buf64 |= static_cast<uint64_t>(read_be32(ptr)) << (64 - buf64_size);
+                ptr += 4;
+            }
+        }
+
+        // expand the symbol until the value at the offset is reached
+        while (d->symlen[sym]) {
+            auto left = d->btree[sym].left();
+
+            if (offset < d->symlen[left] + 1) {
+                sym = left;
+            } else {
+                offset -= d->symlen[left] + 1;
+                sym = d->btree[sym].right();
+            }
+        }
+
+        return d->btree[sym].left();
+    }
+
+    /**
+     * dtz tables only store one player to move, except symmetric tables without pawns.
+     */
+    bool check_dtz_stm(TBTable& table, int stm, int file) {
+        if (table.type == WDL) {
+            return true;
+        }
+
+        auto flags = table.get(stm, file)->flags;
+        return (flags & STM) == stm || (table.key == table.key2 && !table.has_pawns);
+    }
+
+    /**
+     * Converts the stored value into a wdl score or a dtz in plies.
+     */
+    int map_score(TBTable& table, int file, int value, WDLScore wdl) {
+        if (table.type == WDL) {
+            return value - 2;
+        }
+
+        constexpr int WDL_MAP[] = {1, 3, 0, 2, 0};
+
+        auto d = table.get(0, file);
+        auto flags = d->flags;
+
+        if (flags & MAPPED) {
+            auto index = static_cast<size_t>(d->map_idx[WDL_MAP[wdl + 2]] + value);
+            value = (flags & WIDE) ? read_le16(table.map + 2 * index) : table.map[index];
+        }
+
+        // the distance is stored in moves, unless the table stores plies
+        if ((wdl == WDL_WIN && !(flags & WIN_PLIES)) ||
+            (wdl == WDL_LOSS && !(flags & LOSS_PLIES)) ||
+            wdl == WDL_CURSED_WIN ||
+            wdl == WDL_BLESSED_LOSS) {
+            value *= 2;
+        }
+
+        return value + 1;
+    }
+
+    bool pawns_compare(int a, int b) {
+        return TABLES.map_pawns[a] < TABLES.map_pawns[b];
+    }
+
+    /**
+     * Computes the index of the position in the table and reads its value.
+     * @param position The position.
+     * @param table The table of the material of the position.
+     * @param wdl The wdl score of the position, only used for dtz tables.
+     * @param result Set to PROBE_CHANGE_STM if the dtz table does not store this player to move.
+     */
+    int do_probe_table(const TBPosition& position, TBTable& table, WDLScore wdl, ProbeState& result) {
+        int squares[TB_PIECES];
+        int pieces[TB_PIECES];
+        int size = 0;
+        int lead_pawns_count = 0;
+        int tb_file = 0;
+        uint64_t idx;
+
+        // symmetric tables only store white to move,
+        // and the tables are created with the stronger side as white.
+        // otherwise the colors are switched and the board is flipped
+        auto symmetric_black_to_move = table.key == table.key2 && position.side_to_move;
+        auto black_stronger = position.material_key != table.key;
+        auto flip = symmetric_black_to_move || black_stronger;
+        auto flip_color = flip ? BLACK_OFFSET : 0;
+        auto flip_squares = flip ? 56 : 0;
+        auto stm = static_cast<int>(flip) ^ position.side_to_move;
+
+        bool is_lead_pawn[TB_PIECES]{};
+
+        // with pawns the table is split by the file of the leading pawn
+        if (table.has_pawns) {
+            auto lead_piece = table.get(0, 0)->pieces[0] ^ flip_color;
+
+            for (int i = 0; i < position.count; ++i) {
+                if (position.pieces[i] == lead_piece) {
+                    squares[size++] = position.squares[i] ^ flip_squares;
+                    is_lead_pawn[i] = true;
+                }
+            }
+
+            lead_pawns_count = size;
+            std::swap(squares[0], *std::max_element(squares, squares + lead_pawns_count, pawns_compare));
+            tb_file = edge_distance(file_of(squares[0]));
+        }
+
+        if (!check_dtz_stm(table, stm, tb_file)) {
+            result = PROBE_CHANGE_STM;
+            return 0;
+        }
+
+        for (int i = 0; i < position.count; ++i) {
+            if (!is_lead_pawn[i]) {
+                squares[size] = position.squares[i] ^ flip_squares;
+                pieces[size++] = position.pieces[i] ^ flip_color;
+            }
+        }
+
+        auto d = table.get(stm, tb_file);
+
+        // order the pieces like they are stored in the table
+        for (int i = lead_pawns_count; i < size - 1; ++i) {
+            for (int j = i + 1; j < size; ++j) {
+                if (d->pieces[i] == pieces[j]) {
+                    std::swap(pieces[i], pieces[j]);
+                    std::swap(squares[i], squares[j]);
+                    break;
+                }
+            }
+        }
+
+        // the leading piece has to be on the files a to d
+        if (file_of(squares[0]) > 3) {
+            for (int i = 0; i < size; ++i) {
+                squares[i] = flip_file(squares[i]);
+            }
+        }
+
+        if (table.has_pawns) {
+            idx = TABLES.lead_pawn_idx[lead_pawns_count][squares[0]];
+
+            std::stable_sort(squares + 1, squares + lead_pawns_count, pawns_compare);
+
+            for (int i = 1; i < lead_pawns_count; ++i) {
+                idx += TABLES.binomial[i][TABLES.map_pawns[squares[i]]];
+            }
+        } else {
+            // without pawns the leading piece also has to be on the ranks 1 to 4
+            if (rank_of(squares[0]) > 3) {
+                for (int i = 0; i < size; ++i) {
+                    squares[i] = flip_rank(squares[i]);
+                }
+            }
+
+            // the first piece of the leading group that is not on the a1-h8 diagonal has to be below it
+            for (int i = 0; i < d->group_len[0]; ++i) {
+                if (!off_a1h8(squares[i])) {
+                    continue;
+                }
+
+                if (off_a1h8(squares[i]) > 0) {
+                    for (int j = i; j < size; ++j) {
+                        squares[j] = ((squares[j] >> 3) | (squares[j] << 3)) & 63;
+                    }
+                }
+                break;
+            }
+
+            if (table.has_unique_pieces) {
+                // the kings and one unique piece are encoded together
+                int adjust1 = squares[1] > squares[0];
+                int adjust2 = (squares[2] > squares[0]) + (squares[2] > squares[1]);
+
+                if (off_a1h8(squares[0])) {
+                    idx = static_cast<uint64_t>((TABLES.map_a1d1d4[squares[0]] * 63 + (squares[1] - adjust1)) * 62 +
+                                                squares[2] - adjust2);
+                } else if (off_a1h8(squares[1])) {
+                    idx = static_cast<uint64_t>((6 * 63 + rank_of(squares[0]) * 28 + TABLES.map_b1h1h7[squares[1]]) * 62 +
+                                                squares[2] - adjust2);
+                } else if (off_a1h8(squares[2])) {
+                    idx = static_cast<uint64_t>(6 * 63 * 62 + 4 * 28 * 62 +
+                                                rank_of(squares[0]) * 7 * 28 +
+                                                (rank_of(squares[1]) - adjust1) * 28 +
+                                                TABLES.map_b1h1h7[squares[2]]);
+                } else {
+                    idx = static_cast<uint64_t>(6 * 63 * 62 + 4 * 28 * 62 + 4 * 7 * 28 +
+                                                rank_of(squares[0]) * 7 * 6 +
+                                                (rank_of(squares[1]) - adjust1) * 6 +
+                                                (rank_of(squares[2]) - adjust2));
+                }
+            } else {
+                // only the two kings are encoded together
+                idx = static_cast<uint64_t>(TABLES.map_kk[TABLES.map_a1d1d4[squares[0]]][squares[1]]);
+            }
+        }
+
+        idx *= d->group_idx[0];
+        auto group_squares = squares + d->group_len[0];
+
+        // the remaining groups are encoded with the squares in ascending order,
+        // skipping the squares that are taken by the groups before
+        auto remaining_pawns = table.has_pawns && table.pawn_count[1];
+        int next = 0;
+
+        while (d->group_len[++next]) {
+            std::stable_sort(group_squares, group_squares + d->group_len[next]);
+            uint64_t n = 0;
+
+            for (int i = 0; i < d->group_len[next]; ++i) {
+                auto square = group_squares[i];
+                auto adjust = std::count_if(squares, group_squares, [square](int s) { return square > s; });
+                auto index = square - static_cast<int>(adjust) - 8 * remaining_pawns;
+                n += TABLES.binomial[i + 1][index];
+            }
+
+            remaining_pawns = false;
+            idx += n * d->group_idx[next];
+            group_squares += d->group_len[next];
+        }
+
+        return map_score(table, tb_file, decompress_pairs(d, idx), wdl);
+    }
+
+    /**
+     * Collects the pieces of the board in the encoding of the tables.
+     */
+    TBPosition to_tb_position(const GameBoard& board, Color side_to_move) {
+        TBPosition position;
+        int counts[2][7]{};
+
+        // the squares are collected from a1 to h8
+        for (int square = 0; square < 64; ++square) {
+            auto piece = board.get_piece(board.absolute({square / 8, square % 8}));
+            if (!piece || position.count == TB_PIECES) {
+                continue;
+            }
+
+            auto color = (piece->get_color() == Color::WHITE) ? 0 : 1;
+            auto code = piece_code(piece->get_name());
+
+            position.squares[position.count] = square;
+            position.pieces[position.count++] = code + color * BLACK_OFFSET;
+            ++counts[color][code];
+        }
+
+        position.side_to_move = (side_to_move == Color::WHITE) ? 0 : 1;
+        position.material_key = material_key(counts);
+        return position;
+    }
+
+    /**
+     * Probes the wdl or dtz table of the position.
+     */
+    int probe_table(TBType type, const GameBoard& board, Color side_to_move, ProbeState& result, WDLScore wdl = WDL_DRAW) {
+        auto position = to_tb_position(board, side_to_move);
+
+        // king against king
+        if (position.count == 2) {
+            return WDL_DRAW;
+        }
+
+        auto entry = tables_by_key.find(position.material_key);
+        if (entry == tables_by_key.end()) {
+            result = PROBE_FAIL;
+            return 0;
+        }
+
+        auto& table = (type == WDL) ? *entry->second.first : *entry->second.second;
+        if (!mapped(table)) {
+            result = PROBE_FAIL;
+            return 0;
+        }
+
+        return do_probe_table(position, table, wdl, result);
+    }
+
+    bool is_zeroing(const GameBoard& board, const Move& move) {
+        return MoveGen::is_capture(board, move) || board.get_piece(move.get_from())->get_name() == 'P';
+    }
+
+    /**
+     * The tables do not store the best value of positions where a capture (or a pawn move for dtz) is best,
+     * these positions are "don't care" values to improve the compression.
+     * So the captures have to be searched as well, the best result of both is the correct one.
+     * The tables also do not know en passant, which is a capture as well.
+     */
+    WDLScore search(GameBoard& board, Color side_to_move, ProbeState& result, bool check_zeroing_moves) {
+        auto best_value = WDL_LOSS;
+        auto enemy = enemy_of(side_to_move);
+
+        MoveList moves;
+        MoveGen::generate_legal(board, side_to_move, moves);
+        int move_count = 0;
+
+        for (const auto& move : moves) {
+            if (!MoveGen::is_capture(board, move) &&
+                (!check_zeroing_moves || board.get_piece(move.get_from())->get_name() != 'P')) {
+                continue;
+            }
+
+            ++move_count;
+
+            auto child = GameBoard{board};
+            child.make_move(move);
+            child.flip();
+
+            auto value = static_cast<WDLScore>(-search(child, enemy, result, false));
+
+            if (result == PROBE_FAIL) {
+                return WDL_DRAW;
+            }
+
+            if (value > best_value) {
+                best_value = value;
+
+                if (value >= WDL_WIN) {
+                    result = PROBE_ZEROING_BEST_MOVE;
+                    return value;
+                }
+            }
+        }
+
+        // if all moves were searched, the table does not have to be probed
+        // and it could be wrong, for example with en passant
+        auto no_more_moves = move_count && move_count == moves.size();
+        WDLScore value;
+
+        if (no_more_moves) {
+            value = best_value;
+        } else {
+            value = static_cast<WDLScore>(probe_table(WDL, board, side_to_move, result));
+
+            if (result == PROBE_FAIL) {
+                return WDL_DRAW;
+            }
+        }
+
+        if (best_value >= value) {
+            result = (best_value > WDL_DRAW || no_more_moves) ? PROBE_ZEROING_BEST_MOVE : PROBE_OK;
+            return best_value;
+        }
+
+        result = PROBE_OK;
+        return value;
+    }
+
+    int dtz_before_zeroing(WDLScore wdl) {
+        switch (wdl) {
+            case WDL_WIN: return 1;
+            case WDL_CURSED_WIN: return 101;
+            case WDL_BLESSED_LOSS: return -101;
+            case WDL_LOSS: return -1;
+            default: return 0;
+        }
+    }
+
+    int sign_of(int value) {
+        return (value > 0) - (value < 0);
+    }
+}
+
+// *****************************************************
+// Public Methods
+// *****************************************************
+
+/**
+ * Registers all tablebase files found in the given directories.
+ * The files are only mapped when they are probed the first time.
+ * @param paths The directories, separated by ':'. An empty string disables the tablebases.
+ */
+void Tablebases::init(const std::string& paths) {
+    clear_tables();
+    directories.clear();
+
+    std::stringstream stream(paths);
+    std::string directory;
+
+    while (std::getline(stream, directory, ':')) {
+        if (directory.empty()) {
+            continue;
+        }
+
+        directories.push_back(directory);
+
+        std::error_code error;
+        for (const auto& file : std::filesystem::directory_iterator(directory, error)) {
+            if (file.path().extension() == ".rtbw" && file.path().stem().string().size() - 1 <= TB_PIECES) {
+                add_table(file.path().stem().string());
+            }
+        }
+    }
+}
+
+/**
+ * Gets the number of pieces of the largest table found.
+ * @return The number of pieces, 0 if there are no tables.
+ */
+int Tablebases::max_pieces() {
+    return largest_table;
+}
+
+/**
+ * Checks if the position is small enough for the tables.
+ * The tables do not store castling rights, so positions with castling rights can not be probed.
+ */
+bool Tablebases::can_probe(const GameBoard& board) {
+    if (!largest_table || board.get_castling_rights()) {
+        return false;
+    }
+
+    int count = 0;
+    for (int x = 0; x < 8; ++x) {
+        for (int y = 0; y < 8; ++y) {
+            if (board.get_piece({x, y}) && ++count > largest_table) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Probes the win/draw/loss tables.
+ * @param board The gameboard, unchanged after the call.
+ * @param side_to_move The color of the player to move.
+ * @param result Set to PROBE_FAIL if the position could not be probed.
+ * @return The result for the player to move, assuming the halfmove clock is 0.
+ */
+WDLScore Tablebases::probe_wdl(GameBoard& board, Color side_to_move, ProbeState& result) {
+    result = PROBE_OK;
+    return search(board, side_to_move, result, false);
+}
+
+/**
+ * Probes the distance to zeroing tables.
+ * The distance is the number of plies until the next capture or pawn move that keeps the result,
+ * for a winning position this is the fastest way to make progress.
+ * @param board The gameboard, unchanged after the call.
+ * @param side_to_move The color of the player to move.
+ * @param result Set to PROBE_FAIL if the position could not be probed.
+ * @return The distance in plies, positive for a win, negative for a loss and 0 for a draw.
+ *         Wins and losses that are drawn by the fifty move rule are 100 plies further away.
+ */
+int Tablebases::probe_dtz(GameBoard& board, Color side_to_move, ProbeState& result) {
+    result = PROBE_OK;
+    auto wdl = search(board, side_to_move, result, true);
+
+    // draws are not stored
+    if (result == PROBE_FAIL || wdl == WDL_DRAW) {
+        return 0;
+    }
+
+    if (result == PROBE_ZEROING_BEST_MOVE) {
+        return dtz_before_zeroing(wdl);
+    }
+
+    auto dtz = probe_table(DTZ, board, side_to_move, result, wdl);
+
+    if (result == PROBE_FAIL) {
+        return 0;
+    }
+
+    if (result != PROBE_CHANGE_STM) {
+        return (dtz + 100 * (wdl == WDL_BLESSED_LOSS || wdl == WDL_CURSED_WIN)) * sign_of(wdl);
+    }
+
+    // the table stores the other player to move, so look one move ahead for the best distance
+    auto enemy = enemy_of(side_to_move);
+    int min_dtz = 0xFFFF;
+
+    MoveList moves;
+    MoveGen::generate_legal(board, side_to_move, moves);
+
+    for (const auto& move : moves) {
+        auto zeroing = is_zeroing(board, move);
+
+        auto child = GameBoard{board};
+        child.make_move(move);
+        child.flip();
+
+        // for zeroing moves the distance before the move is used
+        dtz = zeroing ? -dtz_before_zeroing(search(child, enemy, result, false))
+                      : -probe_dtz(child, enemy, result);
+
+        // a mate is always the fastest move
+        if (dtz == 1 && MoveGen::in_check(child, enemy) && !MoveGen::has_legal_move(child, enemy)) {
+            min_dtz = 1;
+        }
+
+        if (!zeroing) {
+            dtz += sign_of(dtz);
+        }
+
+        if (dtz < min_dtz && sign_of(dtz) == sign_of(wdl)) {
+            min_dtz = dtz;
+        }
+
+        if (result == PROBE_FAIL) {
+            return 0;
+        }
+    }
+
+    // without legal moves the position is mate
+    return (min_dtz == 0xFFFF) ? -1 : min_dtz;
+}
+
+/**
+ * Ranks the moves of the root position with the dtz tables.
+ * The moves are ranked by their result first, the fifty move rule turns wins and losses
+ * that take too long into cursed wins and blessed losses. Within the same result
+ * the fastest win and the slowest loss come first.
+ * Only the moves with the best rank are kept in the list.
+ * @param board The gameboard, unchanged after the call.
+ * @param side_to_move The color of the player to move.
+ * @param moves The legal moves, reduced to the best ranked moves.
+ * @param best_wdl The result of the kept moves with the halfmove clock of the position.
+ * @return false if the position could not be probed, the moves are unchanged then.
+ */
+bool Tablebases::root_probe(GameBoard& board, Color side_to_move, MoveList& moves, WDLScore& best_wdl) {
+    if (!can_probe(board) || moves.empty()) {
+        return false;
+    }
+
+    auto halfmove_clock = board.get_halfmove_clock();
+    auto enemy = enemy_of(side_to_move);
+    ProbeState result = PROBE_OK;
+
+    // the result first, the negated distance second, so the fastest win and the slowest loss rank highest
+    std::pair<WDLScore, int> ranks[MoveList::CAPACITY];
+
+    for (int i = 0; i < moves.size(); ++i) {
+        const auto& move = moves[i];
+        auto zeroing = is_zeroing(board, move);
+
+        auto child = GameBoard{board};
+        child.make_move(move);
+        child.flip();
+
+        int dtz;
+        if (zeroing) {
+            dtz = dtz_before_zeroing(static_cast<WDLScore>(-probe_wdl(child, enemy, result)));
+        } else {
+            dtz = -probe_dtz(child, enemy, result);
+            dtz = (dtz > 0) ? dtz + 1 : (dtz < 0) ? dtz - 1 : dtz;
+        }
+
+        if (result == PROBE_FAIL) {
+            return false;
+        }
+
+        // a mating move is always the fastest
+        if (dtz == 2 && MoveGen::in_check(child, enemy) && !MoveGen::has_legal_move(child, enemy)) {
+            dtz = 1;
+        }
+
+        // a win or loss is only real if the next capture or pawn move comes before the fifty move rule ends the game
+        auto wdl = (dtz > 0) ? ((dtz + halfmove_clock <= 99) ? WDL_WIN : WDL_CURSED_WIN)
+                 : (dtz < 0) ? ((-dtz + halfmove_clock <= 100) ? WDL_LOSS : WDL_BLESSED_LOSS)
+                 : WDL_DRAW;
+        ranks[i] = {wdl, -dtz};
+    }
+
+    // keep only the best moves
+    MoveList best_moves;
+    auto best_rank = *std::max_element(ranks, ranks + moves.size());
+
+    for (int i = 0; i < moves.size(); ++i) {
+        if (ranks[i] == best_rank) {
+            best_moves.push_back(moves[i]);
+        }
+    }
+
+    best_wdl = best_rank.first;
+
+    moves = best_moves;
+    return true;
+}
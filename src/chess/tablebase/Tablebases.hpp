@@ -0,0 +1,56 @@
+/*
+  Syzygy tablebase probing, derived from the probing code of Stockfish
+  Copyright (C) 2004-2024 The Stockfish developers (see the AUTHORS file of Stockfish)
+  and from the original probing code of the Syzygy tablebases
+  Copyright (c) 2013-2018 Ronald de Man
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <string>
+#include "../gameboard/GameBoard.hpp"
+#include "../color/Color.hpp"
+#include "../movegen/MoveList.hpp"
+
+// result of a win/draw/loss probe, from the perspective of the player to move
+// cursed wins and blessed losses are wins and losses that are drawn by the fifty move rule
+enum WDLScore {
+    WDL_LOSS = -2,
+    WDL_BLESSED_LOSS = -1,
+    WDL_DRAW = 0,
+    WDL_CURSED_WIN = 1,
+    WDL_WIN = 2
+};
+
+enum ProbeState {
+    PROBE_FAIL = 0,              // no table for the position, or the table is corrupt
+    PROBE_OK = 1,
+    PROBE_CHANGE_STM = -1,       // the dtz table stores the position for the other player to move
+    PROBE_ZEROING_BEST_MOVE = 2  // the best move is a capture or a pawn move
+};
+
+// probing of syzygy endgame tablebases
+// the .rtbw (win/draw/loss) and .rtbz (distance to zeroing move) files are read from local directories
+// and memory mapped when they are used the first time, nothing is copied into memory
+class Tablebases {
+public:
+    static void init(const std::string& paths);
+    [[nodiscard]] static int max_pieces();
+    [[nodiscard]] static bool can_probe(const GameBoard& board);
+
+    static WDLScore probe_wdl(GameBoard& board, Color side_to_move, ProbeState& result);
+    static int probe_dtz(GameBoard& board, Color side_to_move, ProbeState& result);
+    static bool root_probe(GameBoard& board, Color side_to_move, MoveList& moves, WDLScore& best_wdl);
+};
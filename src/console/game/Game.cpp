@@ -0,0 +1,533 @@
+#include "Game.hpp"
+#include "hash/Zobrist.hpp"
+#include <chrono>
+#include <ctime>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+
+// *****************************************************
+// Public Methods
+// *****************************************************
+
+/**
+ * Starts the game and runs it until it is over.
+ */
+void Game::play() {
+   VecPos valid_moves;
+
+    // game loop
+    while (valid_moves.empty()) {
+
+        renderer.draw(gameboard);
+
+        // get player input if it is a game of 2 players
+        auto piece = is_human(current_player) ?
+                player_choose_piece(current_player) : ai_choose_piece(current_player);
+
+        // the gameboard function has to return at least one valid move
+        // for the chosen piece, else the player has to choose another piece
+        valid_moves = gameboard.get_valid_moves_for(piece);
+
+        if (!valid_moves.empty()) {
+            // remember the position before the move for the repetition detection
+            history.push(Zobrist::hash(gameboard, current_player));
+            auto board_before_move = GameBoard{gameboard};
+
+            renderer.draw(gameboard, valid_moves);
+            // it has already been checked, that the moves
+            // here are valid, so let the player or ai choose one move
+            // and move the piece
+            auto move = is_human(current_player) ?
+                    player_choose_move(current_player, valid_moves) : ai_choose_move(valid_moves);
+
+            // the ai already knows which piece it wants to promote to
+            if (is_human(current_player)) {
+                // a move entered as text already names its promotion piece
+                if (human_move.get_from() == piece && human_move.get_to() == move && human_move.get_promotion() != ' ') {
+                    gameboard.make_move(human_move);
+                } else {
+                    gameboard.move_piece(piece, move, true);
+                }
+
+                // the human chose the promotion piece while moving
+                auto moved_piece = gameboard.get_piece(move);
+                auto promotion = (board_before_move.get_piece(piece)->get_name() == 'P' && moved_piece->get_name() != 'P') ?
+                        moved_piece->get_name() : ' ';
+                record_move(board_before_move, Move{piece, move, promotion});
+            } else {
+                // a random move was chosen, so always promote to a queen
+                if (!(ai_move.get_from() == piece && ai_move.get_to() == move)) {
+                    auto promotion = (gameboard.get_piece(piece)->get_name() == 'P' && move.get_x() == 7) ? 'Q' : ' ';
+                    ai_move = Move{piece, move, promotion};
+                }
+                gameboard.make_move(ai_move);
+                record_move(board_before_move, ai_move);
+            }
+
+            // piece has been moved, so clear the vector
+            valid_moves.clear();
+
+            // check if the current player has won
+            if (gameboard.is_game_over(current_player)) {
+                print_winner(current_player);
+                return;
+            }
+
+            if (gameboard.is_stalemate(current_player)) {
+                print_winner(Color::DRAW);
+                return;
+            }
+
+            // game is not over, so switch the player
+            // and flip the gameboard
+            switch_player();
+
+            // threefold repetition, fifty moves without capture or pawn move, or not enough material to mate
+            if (gameboard.is_draw(history, current_player)) {
+                print_winner(Color::DRAW);
+                return;
+            }
+
+            record_move_stats();
+
+            // the human is thinking now, so can the ai
+            if (is_human(current_player) && !player_vs_player) {
+                start_pondering();
+            }
+        }
+    }
+}
+
+/**
+ * Opens an opening book for the ai.
+ * The ai plays the moves of the book without searching, as long as the position is in the book.
+ * @param path The path of the polyglot .bin file.
+ * @param max_plies The book is only used for the first max_plies half moves of the game.
+ */
+void Game::open_book(const std::string& path, size_t max_plies) {
+    book.open(path);
+    book_depth = max_plies;
+}
+
+// *****************************************************
+// Private Methods
+// *****************************************************
+
+/**
+ * Asks the player to choose a piece. And checks if the input is valid.
+ * If the input is not valid, the player has to choose another piece.
+ * @param color The player of the player.
+ * @return The position of the chosen piece.
+ */
+Position Game::player_choose_piece(Color color) {
+    print_player_action(color, "choose a piece (or enter a move like e2e4 or Nf3)");
+
+    auto result = read_piece_or_move(color);
+
+    while (!result.is_valid()) {
+        std::cout << "Invalid input! Try again: ";
+        result = read_piece_or_move(color);
+    }
+
+    return result;
+}
+
+/**
+ * Reads the field of a piece like E2, or a whole move in the uci or the standard algebraic notation.
+ * A whole move is remembered for player_choose_move.
+ * @param color The color of the player.
+ * @return The position of the chosen piece, invalid if the input is not valid.
+ */
+Position Game::read_piece_or_move(Color color) {
+    std::string input;
+    std::cin >> input;
+    human_move = Move{};
+
+    if (auto field = to_field(input); !field.empty()) {
+        return gameboard.check_piece(get_position(field), color);
+    }
+
+    auto move = Notation::from_uci(gameboard, color, input);
+    if (!move.is_valid()) {
+        move = Notation::from_san(gameboard, color, input);
+    }
+
+    human_move = move;
+    return move.is_valid() ? move.get_from() : Position{};
+}
+
+/**
+ * Prints the action of the player.
+ * @param color The player of the player.
+ * @param action The action of the player.
+ */
+void Game::print_player_action(Color color, const std::string& action) {
+    auto player_color =
+            (color == Color::WHITE) ? "White" : "Black";
+
+    std::cout << "Player " << player_color << " " << action << std::endl;
+}
+
+/**
+ * Asks the player to choose a move. And checks if the input is valid.
+ * If the input is not valid, the player has to choose another move.
+ * The user input has to be a valid move for the chosen piece.
+ * @param color The player of the player.
+ * @param valid_moves The vector of valid moves.
+ * @return The result of the chosen move.
+ */
+Position Game::player_choose_move(Color color, const VecPos& valid_moves) {
+    // the whole move has already been entered
+    if (human_move.is_valid() && human_move.get_to().exists_in(valid_moves)) {
+        return human_move.get_to();
+    }
+
+    print_player_action(color, "choose a move");
+
+    auto input = get_input();
+    auto result = get_position(input);
+
+    while (
+            !result.is_valid() ||
+            !result.exists_in(valid_moves)
+    ) {
+        std::cout << "Invalid input! Try again: ";
+        input = get_input();
+        result = get_position(input);
+    }
+
+    return result;
+}
+
+/**
+ * Asks the ai to choose a piece.
+ * The move is taken from the opening book if possible, otherwise the search
+ * (or the ponder search, if the human played the expected move) decides on the whole move, the piece of the move is returned
+ * and the move is remembered for ai_choose_move.
+ * If the search finds no move, a random piece is chosen.
+ * @param color The player of the ai.
+ * @return The position of the chosen piece.
+ */
+Position Game::ai_choose_piece(Color color) {
+    // if the human played the expected move, the ai has already been searching this position
+    auto pondered = finish_pondering(color);
+
+    // known openings are played from the book without searching
+    if (book.is_open() && history.size() < book_depth) {
+        ai_move = book.probe(gameboard, color, random);
+        ponder_move = Move{};
+
+        if (ai_move.is_valid()) {
+            return ai_move.get_from();
+        }
+    }
+
+    auto result = pondered.best_move.is_valid() ? pondered : think(color);
+    ai_move = result.best_move;
+    ponder_move = result.ponder_move;
+
+    if (ai_move.is_valid()) {
+        return ai_move.get_from();
+    }
+
+    auto position = Position(-1, -1);
+
+    while (!position.is_valid()) {
+        // get two random numbers between 0 and 7
+        auto x = static_cast<int>(random.below(8));
+        auto y = static_cast<int>(random.below(8));
+
+        // convert the numbers to a position
+        position = Position(x, y);
+        position = gameboard.check_piece(position, color);
+    }
+
+    return position;
+}
+
+/**
+ * Asks the ai to choose a one of the valid moves.
+ * This is the move found by the search, if the gameboard agrees that it is valid.
+ * Otherwise a random move is chosen.
+ * @param valid_moves The vector of valid moves.
+ * @return The position of the chosen move.
+ */
+Position Game::ai_choose_move(const VecPos &valid_moves) {
+    if (ai_move.is_valid() && ai_move.get_to().exists_in(valid_moves)) {
+        return ai_move.get_to();
+    }
+
+    Position result;
+    auto vector_size = valid_moves.size();
+
+    // get a random number between 0 and the size of the vector
+    auto random_number = random.below(vector_size);
+    result = valid_moves[random_number];
+
+    return result;
+}
+
+/**
+ * Gets the user input.
+ * @return The user input.
+ */
+std::string Game::get_input() {
+    std::string input;
+    std::cin >> input;
+
+    return to_field(input);
+}
+
+/**
+ * Checks if the input is a field like E2.
+ * @param input The user input.
+ * @return The field, empty if the input is not a field.
+ */
+std::string Game::to_field(const std::string& input) {
+    if (input.size() != 2) {
+        return "";
+    }
+
+    const std::string characters = "ABCDEFGH";
+    const std::string numbers = "12345678";
+
+    if (characters.find(input[0]) == std::string::npos) {
+        return "";
+    }
+
+    if (numbers.find(input[1]) == std::string::npos) {
+        return "";
+    }
+
+    return input;
+}
+
+/**
+ * Gets the position from the user input.
+ * Therefore the string is converted to integers and
+ * the representative position on the gameboard is returned.
+ * @param input The user input.
+ * @return The position.
+ */
+Position Game::get_position(std::string field) {
+    int row, column;
+
+    if (gameboard.is_flipped()) {
+        row = 7 - (field[1] - '1');
+        column = 7 - (field[0] - 'A');
+    } else {
+        row = field[1] - '1';
+        column = field[0] - 'A';
+    }
+
+    //int row = field[1] - '1';
+    //int column = field[0] - 'A';
+
+    return {row, column};
+}
+
+/**
+ * Prints the winner of the game.
+ * @param color The player of the winner.
+ */
+void Game::print_winner(Color winner) {
+    record_move_stats();
+    write_stats();
+    write_pgn(winner);
+
+    renderer.draw(gameboard);
+    switch (winner) {
+        case Color::WHITE:
+            std::cout << "White wins!" << std::endl;
+            break;
+        case Color::BLACK:
+            std::cout << "Black wins!" << std::endl;
+            break;
+        case Color::DRAW:
+        case Color::NONE:
+        default:
+            std::cout << "Draw!" << std::endl;
+            break;
+    }
+}
+
+/**
+ * Switches the current player.
+ * And flips the gameboard.
+ * So the player can see the board from the other side.
+ */
+void Game::switch_player() {
+    current_player = (current_player == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    gameboard.flip();
+}
+
+/**
+ * Checks if the player of the given color is a human.
+ * @param color The color of the player.
+ * @return true if the moves of the player are entered on the console.
+ */
+bool Game::is_human(Color color) const {
+    return player_vs_player || color == human_color;
+}
+
+/**
+ * Searches the move of the ai, the progress of the search is shown below the board.
+ * When the ai plays against itself, every move takes at least a second so it can be followed,
+ * the search runs during that second instead of after it.
+ * @param color The color of the ai.
+ * @return The result of the search.
+ */
+SearchResult Game::think(Color color) {
+    auto start = std::chrono::steady_clock::now();
+
+    auto handle = search.think_async(gameboard, color, ai_limits, history, [](const SearchResult& progress) {
+        std::cout << "\rThinking: depth " << progress.depth << ", score " << progress.score
+                  << ", nodes " << progress.nodes << std::flush;
+    });
+
+    if (!player_vs_player && human_color == Color::NONE) {
+        std::this_thread::sleep_until(start + std::chrono::seconds(1));
+    }
+
+    auto result = handle.get();
+    std::cout << std::endl;
+    return result;
+}
+
+/**
+ * Starts searching the position after the expected reply of the human in the background.
+ * The ai has to be the player that moved last, the expected reply is the one found by its last search.
+ */
+void Game::start_pondering() {
+    if (!ponder_move.is_valid()) {
+        return;
+    }
+
+    auto ai_color = enemy_of(current_player);
+
+    auto ponder_history = history;
+    ponder_history.push(Zobrist::hash(gameboard, current_player));
+
+    auto board = GameBoard{gameboard};
+    board.make_move(ponder_move);
+    board.flip();
+    ponder_key = Zobrist::hash(board, ai_color);
+
+    auto limits = ai_limits;
+    limits.ponder = true;
+    ponder_search = search.think_async(board, ai_color, limits, ponder_history);
+}
+
+/**
+ * Ends the ponder search, if there is one.
+ * If the human played the expected move, the search continues with the normal limits,
+ * otherwise it is cancelled.
+ * @param color The color of the ai.
+ * @return The result of the ponder search, the best move is invalid if the human played another move.
+ */
+SearchResult Game::finish_pondering(Color color) {
+    if (!ponder_search.valid()) {
+        return SearchResult{};
+    }
+
+    auto hit = Zobrist::hash(gameboard, color) == ponder_key;
+
+    if (hit) {
+        search.ponder_hit();
+    } else {
+        ponder_search.cancel();
+    }
+
+    auto result = ponder_search.get();
+    return hit ? result : SearchResult{};
+}
+
+/**
+ * Remembers the statistics of the half move that was just played.
+ * The time the ai ponders is part of the half move of the human.
+ */
+void Game::record_move_stats() {
+    if (!Stats::ENABLED) {
+        return;
+    }
+
+    auto now = Stats::snapshot();
+    move_stats.push_back(now - move_start);
+    move_start = now;
+}
+
+/**
+ * Writes the statistics of every half move and of the whole game as json,
+ * to the file given by the environment variable CHESS_STATS_FILE or to stats.json.
+ */
+void Game::write_stats() const {
+    if (!Stats::ENABLED) {
+        return;
+    }
+
+    auto path = std::getenv("CHESS_STATS_FILE");
+    std::ofstream file(path ? path : "stats.json");
+
+    StatsSnapshot total;
+    file << "{\n  \"moves\": [\n";
+
+    for (size_t i = 0; i < move_stats.size(); ++i) {
+        total += move_stats[i];
+        file << "    {\"ply\": " << i + 1 << ", \"stats\": " << move_stats[i].to_json() << "}"
+             << (i + 1 < move_stats.size() ? "," : "") << "\n";
+    }
+
+    file << "  ],\n  \"game\": " << total.to_json() << "\n}" << std::endl;
+}
+
+/**
+ * Adds a move to the moves of the game.
+ * @param board The gameboard before the move.
+ * @param move The move that was played.
+ */
+void Game::record_move(GameBoard& board, const Move& move) {
+    moves.push_back(move);
+    san_moves.push_back(Notation::to_san(board, current_player, move).str());
+}
+
+/**
+ * Appends the game in the portable game notation to the file given by the environment variable CHESS_PGN_FILE.
+ * Without it nothing is written.
+ * @param winner The color of the winner, DRAW for a draw.
+ */
+void Game::write_pgn(Color winner) const {
+    auto path = std::getenv("CHESS_PGN_FILE");
+    if (!path) {
+        return;
+    }
+
+    auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    char date[11];
+    std::strftime(date, sizeof(date), "%Y.%m.%d", std::localtime(&now));
+
+    auto player_name = [this](Color color) {
+        return is_human(color) ? "Human" : "Computer";
+    };
+
+    PgnGame game;
+    game.result = (winner == Color::WHITE) ? "1-0" : (winner == Color::BLACK) ? "0-1" : "1/2-1/2";
+    game.set_tag("Event", "Console Chess");
+    game.set_tag("Site", "?");
+    game.set_tag("Date", date);
+    game.set_tag("Round", "-");
+    game.set_tag("White", player_name(Color::WHITE));
+    game.set_tag("Black", player_name(Color::BLACK));
+    game.set_tag("Result", game.result);
+
+    // the test positions do not start from the start position
+    if (start_fen != Fen::START_POSITION) {
+        game.set_tag("SetUp", "1");
+        game.set_tag("FEN", start_fen);
+    }
+
+    game.moves = san_moves;
+
+    std::ofstream file(path, std::ios::app);
+    Pgn::write(game, file);
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include "gameboard/GameBoard.hpp"
+#include "gameboard/BoardRenderer.hpp"
+#include "color/Color.hpp"
+#include "position/Position.hpp"
+#include "position/Move.hpp"
+#include "position/PositionHistory.hpp"
+#include "search/Search.hpp"
+#include "book/OpeningBook.hpp"
+#include "stats/Stats.hpp"
+#include "pgn/Pgn.hpp"
+#include "notation/Notation.hpp"
+#include "fen/Fen.hpp"
+#include "random/Random.hpp"
+#include <cstdlib>
+#include <vector>
+#include <unistd.h>
+
+class Game {
+    GameBoard gameboard;
+    Color current_player;
+    bool player_vs_player;
+    Color human_color{Color::NONE}; // the color of the human playing against the ai, NONE if the ai plays both
+    PositionHistory history;
+
+    // only the changed fields are redrawn on a terminal, unless CHESS_FULL_REDRAW is set
+    BoardRenderer renderer{isatty(STDOUT_FILENO) && !std::getenv("CHESS_FULL_REDRAW")};
+
+    Search search;
+    SearchLimits ai_limits;
+    Move ai_move;
+    Move human_move; // a whole move entered by the human, instead of a piece and its field
+
+    OpeningBook book;
+    size_t book_depth{0};
+
+    // chooses the book moves and the moves of the ai when the search has none, the same seed plays the same choices
+    Random random;
+
+    // the ai searches the expected reply while the human is thinking
+    Move ponder_move;
+    uint64_t ponder_key{0};
+    SearchHandle ponder_search;
+
+    // statistics of every half move, only collected if the engine is built with CHESS_STATS
+    StatsSnapshot move_start;
+    std::vector<StatsSnapshot> move_stats;
+
+    // every move of the game, for the export as pgn
+    std::string start_fen;
+    std::vector<Move> moves;
+    std::vector<std::string> san_moves;
+
+    Position player_choose_piece(Color color);
+    Position read_piece_or_move(Color color);
+    static void print_player_action(Color color, const std::string& action);
+    Position player_choose_move(Color color, const VecPos& valid_moves);
+
+    [[nodiscard]] bool is_human(Color color) const;
+
+    Position ai_choose_piece(Color color);
+    Position ai_choose_move(const VecPos& valid_moves);
+
+    static std::string get_input();
+    static std::string to_field(const std::string& input);
+    [[nodiscard]] Position get_position(std::string input);
+
+    void print_winner(Color winner);
+
+    void switch_player();
+
+    void record_move_stats();
+    void write_stats() const;
+
+    void record_move(GameBoard& board, const Move& move);
+    void write_pgn(Color winner) const;
+
+    SearchResult think(Color color);
+    void start_pondering();
+    SearchResult finish_pondering(Color color);
+
+public:
+    Game(GameTest option, uint64_t seed): gameboard(option), current_player(Color::WHITE), random(seed), move_start(Stats::snapshot()),
+            start_fen(Fen::to_string(gameboard, Color::WHITE)) {
+        ai_limits.time_ms = 1000;
+
+        std::cout << "Welcome to Chess!" << std::endl;
+        std::cout << "Do you want to play against a friend? (y/n): ";
+        std::string input;
+        std::cin >> input;
+        player_vs_player = (input == "y");
+
+        if (!player_vs_player) {
+            std::cout << "Which color do you want to play against the computer? (w/b, anything else to watch): ";
+            std::cin >> input;
+            human_color = (input == "w") ? Color::WHITE : (input == "b") ? Color::BLACK : Color::NONE;
+        }
+    }
+    // the ponder search does not end on its own, its handle cancels it before the search is destroyed
+    ~Game() = default;
+
+    void play();
+    void open_book(const std::string& path, size_t max_plies);
+};
@@ -0,0 +1,52 @@
+#include "pieces/ChessPiece.hpp"
+#include "gameboard/GameBoard.hpp"
+#include "game/Game.hpp"
+#include "tablebase/Tablebases.hpp"
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <stdexcept>
+
+int main() {
+
+    // Possible options for the game_type are:
+
+    // NORMAL, CHECKMATE, STALEMATE, PROMOTION, CASTLING, EN_PASSANT, CHECK
+    // Normal will create a normal game
+    // Checkmate will create a game where white can create a checkmate with one move
+    // Stalemate will create a game where white can create a stalemate with one move
+    // Promotion will create a game where white can promote a pawn with 1 move (and possibly create a checkmate)
+    // En passant will create a game where white can capture a pawn with en passant with 2 moves
+    // Castling will create a game where white/black can castle with 1 move, also the detection of check when castling is tested
+    // Check will create a game where white can create a check with one move
+    auto game_type = GameTest::NORMAL;
+
+    // the directories of the syzygy tablebase files, separated by ':'
+    if (auto syzygy_path = std::getenv("SYZYGY_PATH")) {
+        Tablebases::init(syzygy_path);
+    }
+
+    // the seed of the random choices of the ai, CHESS_SEED repeats the choices of an earlier game
+    auto seed = static_cast<uint64_t>(time(nullptr));
+    size_t book_depth = 16;
+
+    try {
+        if (auto seed_text = std::getenv("CHESS_SEED")) {
+            seed = std::stoull(seed_text);
+        }
+        if (auto book_depth_text = std::getenv("BOOK_DEPTH")) {
+            book_depth = std::stoul(book_depth_text);
+        }
+    } catch (const std::exception&) {
+        std::cerr << "CHESS_SEED and BOOK_DEPTH have to be numbers" << std::endl;
+        return 1;
+    }
+
+    Game game{game_type, seed};
+
+    // a polyglot opening book, used for the first BOOK_DEPTH half moves (default 16)
+    if (auto book_path = std::getenv("BOOK_PATH")) {
+        game.open_book(book_path, book_depth);
+    }
+    game.play();
+}
@@ -0,0 +1,290 @@
+#include "fen/Fen.hpp"
+#include "hash/Zobrist.hpp"
+#include "movegen/MoveGen.hpp"
+#include "random/Random.hpp"
+#include "search/Search.hpp"
+#include "storage/BinaryFile.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+// generates training data for the evaluation: plays fast self-play games from random openings and writes
+// the quiet positions with the score of the search and the result of the game to binary files of positions.
+// every thread writes its own file (prefix_0.bin, prefix_1.bin, ...), the threads only share the set of written positions
+
+namespace {
+    struct Options {
+        int games{100};
+        SearchLimits limits;
+        int random_plies{8};
+        int max_plies{400};
+        bool chess960{false};
+        unsigned int threads{1};
+        size_t hash_mb{16};
+        std::string output{"data"};
+        uint64_t seed{0};
+    };
+
+    // the quiet positions of a game with their zobrist hashes
+    struct GamePositions {
+        std::vector<PackedPosition> positions;
+        std::vector<uint64_t> keys;
+    };
+
+    // the positions of all threads, a position reached in several games is only written once.
+    // the games are taken in the order of their numbers, so the first game reaching a position keeps it,
+    // no matter which thread plays it or when it ends
+    class SeenPositions {
+        std::unordered_set<uint64_t> keys;
+        std::map<int, GamePositions> waiting;
+        int next_game{0};
+        std::mutex mutex;
+    public:
+        /**
+         * Hands in the positions of a game and takes the positions of all games whose earlier games are done.
+         * @param game The number of the game.
+         * @param positions The positions of the game.
+         * @param duplicates Counts the positions that an earlier game already had.
+         * @return The positions not seen before, in the order of the games.
+         */
+        std::vector<PackedPosition> take(int game, GamePositions positions, std::atomic<uint64_t>& duplicates) {
+            std::lock_guard lock(mutex);
+            waiting.emplace(game, std::move(positions));
+
+            std::vector<PackedPosition> result;
+            for (auto it = waiting.find(next_game); it != waiting.end(); it = waiting.find(++next_game)) {
+                const auto& done = it->second;
+                for (size_t i = 0; i < done.positions.size(); ++i) {
+                    if (keys.insert(done.keys[i]).second) {
+                        result.push_back(done.positions[i]);
+                    } else {
+                        ++duplicates;
+                    }
+                }
+                waiting.erase(it);
+            }
+
+            return result;
+        }
+    };
+
+    struct Counters {
+        std::atomic<int> next_game{0};
+        std::atomic<uint64_t> positions{0};
+        std::atomic<uint64_t> duplicates{0};
+    };
+
+    /**
+     * Creates the start position of a game, the normal one or a random chess960 one.
+     */
+    GameBoard start_position(const Options& options, Random& random, Color& side_to_move) {
+        side_to_move = Color::WHITE;
+        if (!options.chess960) {
+            return GameBoard{GameTest::NORMAL};
+        }
+
+        return Fen::parse(Fen::chess960(static_cast<int>(random.below(Fen::CHESS960_POSITIONS))), side_to_move);
+    }
+
+    /**
+     * Plays random legal moves from the start position, so the games differ from each other.
+     * @return false if the game ended during the random moves.
+     */
+    bool play_random_opening(GameBoard& board, Color& side_to_move, int plies, Random& random) {
+        for (int ply = 0; ply < plies; ++ply) {
+            MoveList legal_moves;
+            MoveGen::generate_legal(board, side_to_move, legal_moves);
+            if (legal_moves.size() == 0) {
+                return false;
+            }
+
+            board.make_move(legal_moves[static_cast<int>(random.below(static_cast<uint64_t>(legal_moves.size())))]);
+            board.flip();
+            side_to_move = enemy_of(side_to_move);
+        }
+
+        return true;
+    }
+
+    /**
+     * Plays one game with the same rules as the console game and collects its positions.
+     * Every game has its own generator, created from the seed and the number of the game,
+     * so a game is the same no matter which thread plays it.
+     * @param positions The quiet positions of the game are appended, with the result of the game.
+     */
+    void play_game(Search& search, const Options& options, int game, GamePositions& positions) {
+        Random random{options.seed, static_cast<uint64_t>(game)};
+        Color side_to_move;
+        auto board = start_position(options, random, side_to_move);
+
+        if (!play_random_opening(board, side_to_move, options.random_plies, random)) {
+            return;
+        }
+
+        PositionHistory history;
+        auto winner = Color::DRAW;
+
+        for (int ply = options.random_plies; ply < options.max_plies; ++ply) {
+            auto result = search.think(board, side_to_move, options.limits, history);
+            auto move = result.best_move;
+
+            if (!move.is_valid()) {
+                winner = board.is_king_in_check(side_to_move) ? enemy_of(side_to_move) : Color::DRAW;
+                break;
+            }
+
+            // positions in check, with a capture as best move or with a mate score are not quiet,
+            // the static evaluation cannot be compared with the score of the search there
+            auto quiet = !board.is_king_in_check(side_to_move) && !MoveGen::is_capture(board, move) &&
+                         move.get_promotion() == ' ' && std::abs(result.score) < TB_WIN_BOUND;
+            auto key = Zobrist::hash(board, side_to_move);
+
+            if (quiet) {
+                auto packed = PackedPosition::pack(board, side_to_move, ply / 2 + 1);
+                packed.score = static_cast<int16_t>((side_to_move == Color::WHITE) ? result.score : -result.score);
+                positions.positions.push_back(packed);
+                positions.keys.push_back(key);
+            }
+
+            history.push(key);
+            board.make_move(move);
+
+            if (board.is_game_over(side_to_move)) {
+                winner = side_to_move;
+                break;
+            }
+
+            // only the player to move can be stalemated, otherwise a won game would be labeled a draw
+            if (board.is_stalemate(side_to_move)) {
+                break;
+            }
+
+            side_to_move = enemy_of(side_to_move);
+            board.flip();
+
+            if (board.is_draw(history, side_to_move)) {
+                break;
+            }
+        }
+
+        auto game_result = static_cast<int8_t>((winner == Color::WHITE) ? 1 : (winner == Color::BLACK) ? -1 : 0);
+        for (auto& position : positions.positions) {
+            position.result = game_result;
+        }
+    }
+
+    /**
+     * Plays games until all games are started and writes the new positions to the file of the thread.
+     * Which file a position ends up in depends on the threads, all files together are the same for the same seed.
+     */
+    void work(BinaryWriter& file, const Options& options, SeenPositions& seen, Counters& counters) {
+        Search search{SearchOptions{}, options.hash_mb};
+
+        for (auto game = counters.next_game++; game < options.games; game = counters.next_game++) {
+            search.clear();
+            GamePositions positions;
+            play_game(search, options, game, positions);
+
+            auto new_positions = seen.take(game, std::move(positions), counters.duplicates);
+            for (const auto& position : new_positions) {
+                file.write(position);
+            }
+            counters.positions += new_positions.size();
+        }
+    }
+
+    void print_usage() {
+        std::cout << "Usage: datagen [--games=n] [--nodes=n] [--depth=n] [--random_plies=n] [--max_plies=n] [--threads=n]" << std::endl;
+        std::cout << "               [--chess960] [--hash=mb] [--output=prefix] [--seed=n]" << std::endl;
+        std::cout << "Plays self-play games from random openings and writes the quiet positions with the score and the result" << std::endl;
+        std::cout << "to one binary file of positions per thread, named prefix_0.bin, prefix_1.bin, ... (default data)." << std::endl;
+        std::cout << "Without limits every move is searched with 5000 nodes." << std::endl;
+        std::cout << "With --chess960 the games start from random chess960 start positions." << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    options.limits.depth = 0;
+    options.seed = static_cast<uint64_t>(time(nullptr));
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string argument = argv[i];
+            auto value = argument.substr(argument.find('=') + 1);
+
+            if (argument.rfind("--games=", 0) == 0) {
+                options.games = std::stoi(value);
+            } else if (argument.rfind("--nodes=", 0) == 0) {
+                options.limits.nodes = std::stoull(value);
+            } else if (argument.rfind("--depth=", 0) == 0) {
+                options.limits.depth = std::stoi(value);
+            } else if (argument.rfind("--random_plies=", 0) == 0) {
+                options.random_plies = std::max(0, std::stoi(value));
+            } else if (argument.rfind("--max_plies=", 0) == 0) {
+                options.max_plies = std::stoi(value);
+            } else if (argument.rfind("--threads=", 0) == 0) {
+                options.threads = static_cast<unsigned int>(std::max(1, std::stoi(value)));
+            } else if (argument == "--chess960") {
+                options.chess960 = true;
+            } else if (argument.rfind("--hash=", 0) == 0) {
+                options.hash_mb = std::stoul(value);
+            } else if (argument.rfind("--output=", 0) == 0) {
+                options.output = value;
+            } else if (argument.rfind("--seed=", 0) == 0) {
+                options.seed = std::stoull(value);
+            } else {
+                print_usage();
+                return argument == "--help" ? 0 : 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    // a fixed number of nodes keeps the games fast and the same on every machine
+    if (options.limits.depth <= 0) {
+        if (options.limits.nodes == 0) {
+            options.limits.nodes = 5000;
+        }
+        options.limits.depth = MAX_PLY - 1;
+    }
+
+    // all files are opened before the first game, a thread without its file would lose its games
+    std::vector<BinaryWriter> files(options.threads);
+    for (unsigned int i = 0; i < options.threads; ++i) {
+        if (!files[i].open(options.output + "_" + std::to_string(i) + ".bin", BinaryKind::POSITIONS)) {
+            return 1;
+        }
+    }
+
+    SeenPositions seen;
+    Counters counters;
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (unsigned int i = 0; i < options.threads; ++i) {
+        workers.emplace_back(work, std::ref(files[i]), std::cref(options), std::ref(seen), std::ref(counters));
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    auto positions = counters.positions.load();
+
+    std::cout << "seed: " << options.seed << ", games: " << options.games << ", positions: " << positions << ", duplicates: " << counters.duplicates << std::endl;
+    std::cout << "time: " << seconds << " s, " << static_cast<double>(positions) / seconds << " positions/s" << std::endl;
+
+    return 0;
+}
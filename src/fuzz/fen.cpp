@@ -0,0 +1,37 @@
+#include "fen/Fen.hpp"
+#include "movegen/MoveGen.hpp"
+#include "notation/Notation.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <string_view>
+
+// libFuzzer target of the fen parser. any input may be rejected with std::invalid_argument, but must not crash.
+// an accepted position has to give the same fen when it is written and parsed again,
+// and its moves are generated and written, to reach the code that relies on a parsed board
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    std::string_view text{reinterpret_cast<const char*>(data), size};
+
+    try {
+        Color side_to_move;
+        auto board = Fen::parse(text, side_to_move);
+        auto fen = Fen::to_string(board, side_to_move);
+
+        Color parsed_side;
+        auto parsed = Fen::parse(fen, parsed_side);
+        if (Fen::to_string(parsed, parsed_side) != fen) {
+            std::abort();
+        }
+
+        MoveList moves;
+        MoveGen::generate_legal(board, side_to_move, moves);
+        for (const auto& move : moves) {
+            (void) Notation::to_san(board, side_to_move, move, moves);
+        }
+    } catch (const std::invalid_argument&) {
+        // not a valid position
+    }
+
+    return 0;
+}
@@ -0,0 +1,32 @@
+#include "pgn/Pgn.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+// libFuzzer target of the pgn reader. every input is read as a stream of games and every game is replayed.
+// a game that replays without an error has to be read back with the same moves after it is written
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    std::istringstream in{std::string(reinterpret_cast<const char*>(data), size)};
+    PgnReader reader{in};
+    PgnGame game;
+    std::string error;
+
+    while (reader.next(game)) {
+        if (!Pgn::replay(game, error)) {
+            continue;
+        }
+
+        std::stringstream written;
+        Pgn::write(game, written);
+
+        PgnReader written_reader{written};
+        PgnGame written_game;
+        if (!written_reader.next(written_game) || written_game.moves != game.moves) {
+            std::abort();
+        }
+    }
+
+    return 0;
+}
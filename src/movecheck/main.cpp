@@ -0,0 +1,405 @@
+#include "fen/Fen.hpp"
+#include "gameboard/GameBoard.hpp"
+#include "movegen/MoveGen.hpp"
+#include "notation/Notation.hpp"
+#include "hash/Zobrist.hpp"
+#include "position/PositionHistory.hpp"
+#include "random/Random.hpp"
+#include "storage/PackedPosition.hpp"
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+// checks the move generation before a faster one is trusted.
+// random legal games reach positions that no fixed test thinks of, in every position of them the moves of the
+// engine are compared with the moves the gameboard validates for the console game, the captures, quiet moves and
+// evasions of the generator have to add up to all its moves, and the board is copied, written as fen, flipped and
+// its moves converted to text and back, which all have to give the same position.
+// the perft numbers of known positions check the move generation of the engine on its own
+
+namespace {
+    // a position with the number of leaf nodes for the depths 1, 2, ...
+    struct PerftReference {
+        const char* name;
+        const char* fen;
+        std::vector<uint64_t> nodes;
+    };
+
+    const std::vector<PerftReference> PERFT_REFERENCES = {
+        {"start", Fen::START_POSITION, {20, 400, 8902, 197281}},
+        {"kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", {48, 2039, 97862}},
+        {"endgame", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", {14, 191, 2812, 43238}},
+        {"promotions", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", {6, 264, 9467}},
+        {"promotions mirrored", "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1", {6, 264, 9467}},
+        {"discovered checks", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", {44, 1486, 62379}},
+        {"chess960 1", "bqnb1rkr/pp3ppp/3ppn2/2p5/5P2/P2P4/NPP1P1PP/BQ1BNRKR w HFhf - 2 9", {21, 528, 12189, 326672}},
+        {"chess960 2", "2nnrbkr/p1qppppp/8/1ppb4/6PP/3PP3/PPP2P2/BQNNRBKR w HEhe - 1 9", {21, 807, 18002}},
+        {"chess960 3", "b1q1rrkb/pppppppp/3nn3/8/P7/1PPP4/4PPPP/BQNNRKRB w GE - 1 9", {20, 479, 10471}},
+    };
+
+    struct Options {
+        int games{100};
+        int max_plies{300};
+        bool chess960{false};
+        std::string fen;
+        uint64_t seed{0};
+        bool perft{false};
+    };
+
+    uint64_t perft(GameBoard& board, Color side_to_move, int depth) {
+        MoveList moves;
+        MoveGen::generate_legal(board, side_to_move, moves);
+
+        if (depth <= 1) {
+            return static_cast<uint64_t>(moves.size());
+        }
+
+        uint64_t nodes = 0;
+        for (const auto& move : moves) {
+            auto child = GameBoard{board};
+            child.make_move(move);
+            child.flip();
+            nodes += perft(child, enemy_of(side_to_move), depth - 1);
+        }
+
+        return nodes;
+    }
+
+    /**
+     * Counts the leaf nodes of every reference position and compares them with the known numbers.
+     * @return The number of wrong counts.
+     */
+    int check_perft() {
+        auto failures = 0;
+
+        for (const auto& reference : PERFT_REFERENCES) {
+            Color side_to_move;
+            auto board = Fen::parse(reference.fen, side_to_move);
+
+            for (size_t depth = 1; depth <= reference.nodes.size(); ++depth) {
+                auto nodes = perft(board, side_to_move, static_cast<int>(depth));
+                auto expected = reference.nodes[depth - 1];
+
+                std::cout << reference.name << " depth " << depth << ": " << nodes;
+                if (nodes != expected) {
+                    std::cout << ", expected " << expected << " FAILED";
+                    ++failures;
+                }
+                std::cout << std::endl;
+            }
+        }
+
+        return failures;
+    }
+
+    // moves as uci text, so the moves of boards with different orientations can be compared
+    using MoveSet = std::set<std::string>;
+
+    MoveSet to_set(const GameBoard& board, const MoveList& moves) {
+        MoveSet result;
+        for (const auto& move : moves) {
+            result.insert(Notation::to_uci(board, move).str());
+        }
+        return result;
+    }
+
+    MoveSet legal_moves_of(GameBoard& board, Color side_to_move, GenType type = GenType::ALL) {
+        MoveList moves;
+        MoveGen::generate_legal(board, side_to_move, moves, type);
+        return to_set(board, moves);
+    }
+
+    /**
+     * Asks every piece of the player for its valid moves, like the console game does for the human.
+     * The gameboard does not know the promotion piece, so the moves are written without it.
+     */
+    MoveSet gameboard_moves(const GameBoard& board, Color side_to_move) {
+        MoveSet result;
+
+        for (int x = 0; x < 8; ++x) {
+            for (int y = 0; y < 8; ++y) {
+                auto position = Position(x, y);
+                auto piece = board.get_piece(position);
+                if (!piece || piece->get_color() != side_to_move) {
+                    continue;
+                }
+
+                // get_valid_moves_for remembers the en passant and castling targets, so it gets its own copy
+                auto copy = GameBoard{board};
+                for (const auto& target : copy.get_valid_moves_for(position)) {
+                    result.insert(Notation::to_uci(board, Move(position, target)).str());
+                }
+            }
+        }
+
+        return result;
+    }
+
+    MoveSet without_promotions(const MoveSet& moves) {
+        MoveSet result;
+        for (const auto& move : moves) {
+            result.insert(move.substr(0, 4));
+        }
+        return result;
+    }
+
+    /**
+     * @return An empty string if both sets are equal, otherwise the moves that are only in one of them.
+     */
+    std::string compare(const MoveSet& expected, const MoveSet& actual, const std::string& name) {
+        std::string missing;
+        std::string extra;
+
+        for (const auto& move : expected) {
+            if (!actual.contains(move)) {
+                missing += " " + move;
+            }
+        }
+        for (const auto& move : actual) {
+            if (!expected.contains(move)) {
+                extra += " " + move;
+            }
+        }
+
+        if (missing.empty() && extra.empty()) {
+            return "";
+        }
+        return name + " differs from the move generator, missing:" + (missing.empty() ? " -" : missing) +
+               ", extra:" + (extra.empty() ? " -" : extra);
+    }
+
+    /**
+     * Checks one position of a game.
+     * @return An empty string if the position is fine, otherwise the description of the first difference.
+     */
+    std::string check_position(GameBoard& board, Color side_to_move) {
+        MoveList legal_moves;
+        MoveGen::generate_legal(board, side_to_move, legal_moves);
+        auto legal = to_set(board, legal_moves);
+
+        if (auto error = compare(without_promotions(legal), gameboard_moves(board, side_to_move), "gameboard"); !error.empty()) {
+            return error;
+        }
+
+        // the kinds of moves of the generator have to add up to all moves
+        auto captures = legal_moves_of(board, side_to_move, GenType::CAPTURES);
+        auto quiets = legal_moves_of(board, side_to_move, GenType::QUIETS);
+        auto split = captures;
+        split.insert(quiets.begin(), quiets.end());
+        if (split.size() != captures.size() + quiets.size()) {
+            return "captures and quiet moves overlap";
+        }
+        if (auto error = compare(legal, split, "captures and quiet moves"); !error.empty()) {
+            return error;
+        }
+        if (board.is_king_in_check(side_to_move)) {
+            if (auto error = compare(legal, legal_moves_of(board, side_to_move, GenType::EVASIONS), "evasions"); !error.empty()) {
+                return error;
+            }
+        }
+
+        // the copy constructor has to keep everything the rules depend on, like the moved flags and the last move
+        auto copy = GameBoard{board};
+        if (auto error = compare(legal, legal_moves_of(copy, side_to_move), "copy of the board"); !error.empty()) {
+            return error;
+        }
+
+        auto fen = Fen::to_string(board, side_to_move);
+        Color parsed_side;
+        auto parsed = Fen::parse(fen, parsed_side);
+        if (Fen::to_string(parsed, parsed_side) != fen) {
+            return "fen changes when it is parsed again: " + Fen::to_string(parsed, parsed_side);
+        }
+        if (auto error = compare(legal, legal_moves_of(parsed, parsed_side), "board parsed from the fen"); !error.empty()) {
+            return error;
+        }
+
+        // the binary files and the game server keep positions packed, castling has to survive that as well
+        Color unpacked_side;
+        auto unpacked = PackedPosition::pack(board, side_to_move).unpack(unpacked_side);
+        if (Fen::to_string(unpacked, unpacked_side) != fen) {
+            return "packing changes the board: " + Fen::to_string(unpacked, unpacked_side);
+        }
+        if (auto error = compare(legal, legal_moves_of(unpacked, unpacked_side), "unpacked board"); !error.empty()) {
+            return error;
+        }
+
+        auto flipped = GameBoard{board};
+        flipped.flip();
+        flipped.flip();
+        if (Fen::to_string(flipped, side_to_move) != fen) {
+            return "flipping twice changes the board: " + Fen::to_string(flipped, side_to_move);
+        }
+        if (Zobrist::hash(flipped, side_to_move) != Zobrist::hash(board, side_to_move)) {
+            return "flipping twice changes the hash";
+        }
+
+        for (const auto& move : legal_moves) {
+            auto uci = Notation::to_uci(board, move);
+            if (!(Notation::from_uci(board, legal_moves, uci.view()) == move)) {
+                return "uci move " + uci.str() + " is not parsed as itself";
+            }
+
+            auto san = Notation::to_san(board, side_to_move, move, legal_moves);
+            if (!(Notation::from_san(board, legal_moves, san.view()) == move)) {
+                return "san move " + san.str() + " (" + uci.str() + ") is not parsed as itself";
+            }
+        }
+
+        return "";
+    }
+
+    /**
+     * Checks the end of the game detection of the gameboard after a move, before the board is flipped.
+     * @param mover The player who made the last move.
+     * @return An empty string if the gameboard agrees with the move generator.
+     */
+    std::string check_game_end(const GameBoard& board, Color mover) {
+        auto enemy = enemy_of(mover);
+        auto copy = GameBoard{board};
+        auto checkmate = copy.is_game_over(mover);
+        auto stalemate = GameBoard{board}.is_stalemate(mover);
+
+        auto reply_board = GameBoard{board};
+        reply_board.flip();
+        MoveList replies;
+        MoveGen::generate_legal(reply_board, enemy, replies);
+        auto in_check = reply_board.is_king_in_check(enemy);
+
+        if (checkmate != (replies.empty() && in_check)) {
+            return checkmate ? "gameboard sees a checkmate, but there are legal replies"
+                             : "gameboard misses a checkmate";
+        }
+        if (stalemate != (replies.empty() && !in_check)) {
+            return stalemate ? "gameboard sees a stalemate, but there are legal replies"
+                             : "gameboard misses a stalemate";
+        }
+
+        return "";
+    }
+
+    /**
+     * Plays one game with random legal moves and checks every position of it.
+     * @return false if a check failed, the position and the moves leading to it are printed then.
+     */
+    bool check_game(const Options& options, int game, uint64_t& positions) {
+        Random random{options.seed, static_cast<uint64_t>(game)};
+
+        auto side_to_move = Color::WHITE;
+        auto start_fen = options.fen.empty() ? std::string{Fen::START_POSITION} : options.fen;
+        if (options.chess960) {
+            start_fen = Fen::chess960(static_cast<int>(random.below(Fen::CHESS960_POSITIONS)));
+        }
+
+        // the normal start position is created like in the console game, not from its fen
+        auto normal = options.fen.empty() && !options.chess960;
+        auto board = normal ? GameBoard{GameTest::NORMAL} : Fen::parse(start_fen, side_to_move);
+        PositionHistory history;
+        std::string moves;
+
+        for (int ply = 0; ply < options.max_plies; ++ply) {
+            ++positions;
+            auto error = check_position(board, side_to_move);
+
+            MoveList legal_moves;
+            MoveGen::generate_legal(board, side_to_move, legal_moves);
+
+            Move move;
+            if (error.empty() && !legal_moves.empty()) {
+                move = legal_moves[static_cast<int>(random.below(static_cast<uint64_t>(legal_moves.size())))];
+                moves += ' ';
+                moves += Notation::to_uci(board, move).str();
+
+                history.push(Zobrist::hash(board, side_to_move));
+                board.make_move(move);
+                error = check_game_end(board, side_to_move);
+            }
+
+            if (!error.empty()) {
+                std::cout << "game " << game + 1 << ", half move " << ply + 1 << ": " << error << std::endl;
+                std::cout << "  start: " << start_fen << std::endl;
+                std::cout << "  moves:" << moves << std::endl;
+                return false;
+            }
+
+            if (!move.is_valid()) {
+                break;
+            }
+
+            board.flip();
+            side_to_move = enemy_of(side_to_move);
+
+            if (board.is_draw(history, side_to_move)) {
+                break;
+            }
+        }
+
+        return true;
+    }
+
+    void print_usage() {
+        std::cout << "Usage: movecheck [--games=n] [--max_plies=n] [--seed=n] [--chess960 | --fen=fen] [--perft]" << std::endl;
+        std::cout << "Plays games with random legal moves and checks every position: the move generator against the" << std::endl;
+        std::cout << "valid moves of the gameboard, copies, fen, flipping, the notation and the end of the game." << std::endl;
+        std::cout << "With --perft the move generator is checked against the perft numbers of known positions instead." << std::endl;
+        std::cout << "The exit code is 1 if a check failed, the game is printed with its seed to play it again." << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    options.seed = static_cast<uint64_t>(time(nullptr));
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string argument = argv[i];
+            auto value = argument.substr(argument.find('=') + 1);
+
+            if (argument.rfind("--games=", 0) == 0) {
+                options.games = std::stoi(value);
+            } else if (argument.rfind("--max_plies=", 0) == 0) {
+                options.max_plies = std::stoi(value);
+            } else if (argument.rfind("--seed=", 0) == 0) {
+                options.seed = std::stoull(value);
+            } else if (argument == "--chess960") {
+                options.chess960 = true;
+            } else if (argument.rfind("--fen=", 0) == 0) {
+                options.fen = value;
+                Color side_to_move;
+                (void) Fen::parse(options.fen, side_to_move);
+            } else if (argument == "--perft") {
+                options.perft = true;
+            } else {
+                print_usage();
+                return argument == "--help" ? 0 : 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    if (options.perft) {
+        return check_perft() == 0 ? 0 : 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t positions = 0;
+    auto failures = 0;
+
+    for (int game = 0; game < options.games; ++game) {
+        if (!check_game(options, game, positions)) {
+            ++failures;
+        }
+    }
+
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "seed: " << options.seed << ", games: " << options.games << ", positions: " << positions
+              << ", failures: " << failures << ", time: " << seconds << " s" << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,78 @@
+#include "gameboard/GameBoard.hpp"
+#include "movegen/MoveGen.hpp"
+#include "notation/Notation.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+// counts the leaf nodes of the move tree up to a fixed depth,
+// used to verify the move generation against known numbers and to measure its speed
+
+uint64_t perft(GameBoard& board, Color side_to_move, int depth) {
+    MoveList moves;
+    MoveGen::generate_legal(board, side_to_move, moves);
+
+    if (depth <= 1) {
+        return static_cast<uint64_t>(moves.size());
+    }
+
+    uint64_t nodes = 0;
+    for (const auto& move : moves) {
+        auto child = GameBoard{board};
+        child.make_move(move);
+        child.flip();
+        nodes += perft(child, enemy_of(side_to_move), depth - 1);
+    }
+
+    return nodes;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--help") {
+        std::cout << "Usage: perft [depth] [divide]" << std::endl;
+        std::cout << "Counts the positions after depth half moves from the start position," << std::endl;
+        std::cout << "with divide the count is printed for every move of the start position." << std::endl;
+        return 0;
+    }
+
+    auto max_depth = (argc > 1) ? std::stoi(argv[1]) : 5;
+    auto divide = argc > 2 && std::string(argv[2]) == "divide";
+
+    GameBoard board{GameTest::NORMAL};
+    auto side_to_move = Color::WHITE;
+
+    if (divide) {
+        MoveList moves;
+        MoveGen::generate_legal(board, side_to_move, moves);
+
+        uint64_t total = 0;
+        for (const auto& move : moves) {
+            auto child = GameBoard{board};
+            child.make_move(move);
+            child.flip();
+
+            auto nodes = (max_depth > 1) ? perft(child, enemy_of(side_to_move), max_depth - 1) : 1;
+            total += nodes;
+            std::cout << Notation::to_uci(board, move).view() << ": " << nodes << std::endl;
+        }
+
+        std::cout << "total: " << total << std::endl;
+        return 0;
+    }
+
+    for (int depth = 1; depth <= max_depth; ++depth) {
+        auto start = std::chrono::steady_clock::now();
+        auto nodes = perft(board, side_to_move, depth);
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "depth " << depth
+                  << " nodes " << nodes
+                  << " time " << static_cast<int64_t>(elapsed * 1000) << " ms"
+                  << " nps " << static_cast<uint64_t>(static_cast<double>(nodes) / std::max(elapsed, 1e-9))
+                  << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include "pgn/Pgn.hpp"
+#include "fen/Fen.hpp"
+#include "storage/BinaryFile.hpp"
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// replays every game of pgn files to check that all moves are legal.
+// the files are read as a stream, one game at a time, so archives of any size can be checked
+
+namespace {
+    struct CheckResult {
+        uint64_t games{0};
+        uint64_t invalid_games{0};
+        uint64_t plies{0};
+    };
+
+    /**
+     * Packs the start position of the game, with the result of the game.
+     */
+    PackedPosition pack_start(const PgnGame& game) {
+        auto side_to_move = Color::WHITE;
+        auto fen = game.get_tag("FEN");
+        auto board = fen.empty() ? GameBoard{GameTest::NORMAL} : Fen::parse(fen, side_to_move);
+
+        auto start = PackedPosition::pack(board, side_to_move);
+        start.result = static_cast<int8_t>((game.result == "1-0") ? 1 : (game.result == "0-1") ? -1 : 0);
+        return start;
+    }
+
+    /**
+     * Checks the games of the stream, the valid games are written to the binary file if it is open.
+     */
+    void check(std::istream& in, const std::string& name, bool quiet, BinaryWriter& binary, CheckResult& result) {
+        PgnReader reader{in};
+        PgnGame game;
+        std::string error;
+        std::vector<uint16_t> packed_moves;
+
+        auto pack = [&packed_moves](const GameBoard& board, Color, const Move& move) {
+            packed_moves.push_back(pack_move(board, move));
+        };
+
+        while (reader.next(game)) {
+            ++result.games;
+            result.plies += game.moves.size();
+            packed_moves.clear();
+
+            if (Pgn::replay(game, error, binary.is_open() ? Pgn::MoveVisitor{pack} : Pgn::MoveVisitor{})) {
+                if (binary.is_open()) {
+                    binary.write_game(pack_start(game), packed_moves);
+                }
+            } else {
+                ++result.invalid_games;
+
+                if (!quiet) {
+                    std::cerr << name << ": game " << result.games << " (" << game.get_tag("White") << " - "
+                              << game.get_tag("Black") << "): " << error << std::endl;
+                }
+            }
+        }
+    }
+
+    void print_usage() {
+        std::cout << "Usage: pgncheck [--quiet] [--binary=file] [file|-]..." << std::endl;
+        std::cout << "Replays the games of the pgn files (or standard input) and reports the games with illegal moves." << std::endl;
+        std::cout << "With --binary the valid games are written to a binary file of games." << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> paths;
+    auto quiet = false;
+    std::string binary_path;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+
+        if (argument == "--quiet") {
+            quiet = true;
+        } else if (argument.rfind("--binary=", 0) == 0) {
+            binary_path = argument.substr(argument.find('=') + 1);
+        } else if (argument.rfind("--", 0) == 0) {
+            print_usage();
+            return argument == "--help" ? 0 : 1;
+        } else {
+            paths.push_back(argument);
+        }
+    }
+
+    if (paths.empty()) {
+        paths.emplace_back("-");
+    }
+
+    BinaryWriter binary;
+    if (!binary_path.empty() && !binary.open(binary_path, BinaryKind::GAMES)) {
+        return 1;
+    }
+
+    CheckResult result;
+    auto start = std::chrono::steady_clock::now();
+
+    for (const auto& path : paths) {
+        if (path == "-") {
+            check(std::cin, "stdin", quiet, binary, result);
+            continue;
+        }
+
+        std::ifstream file(path);
+        if (!file) {
+            std::cerr << "Could not open " << path << std::endl;
+            return 1;
+        }
+        check(file, path, quiet, binary, result);
+    }
+
+    binary.close();
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "games: " << result.games << ", invalid: " << result.invalid_games << ", half moves: " << result.plies << std::endl;
+    std::cout << "time: " << seconds << " s, " << static_cast<uint64_t>(static_cast<double>(result.games) / seconds) << " games/s, "
+              << static_cast<uint64_t>(static_cast<double>(result.plies) / seconds) << " half moves/s" << std::endl;
+
+    return result.invalid_games ? 2 : 0;
+}
@@ -0,0 +1,602 @@
+#include "Server.hpp"
+#include "fen/Fen.hpp"
+#include "hash/Zobrist.hpp"
+#include "movegen/MoveGen.hpp"
+#include "notation/Notation.hpp"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <netinet/in.h>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+    // a client sending longer lines or not reading its output is disconnected
+    constexpr size_t MAX_LINE = 4096;
+    constexpr size_t MAX_OUTPUT = 1 << 20;
+    constexpr int MAX_EVENTS = 256;
+
+    /**
+     * Splits the first word of a line from the rest.
+     */
+    std::pair<std::string, std::string> split_command(const std::string& line) {
+        auto start = line.find_first_not_of(' ');
+        if (start == std::string::npos) {
+            return {};
+        }
+
+        auto end = line.find(' ', start);
+        if (end == std::string::npos) {
+            return {line.substr(start), {}};
+        }
+
+        auto rest = line.find_first_not_of(' ', end);
+        return {line.substr(start, end - start), (rest == std::string::npos) ? std::string{} : line.substr(rest)};
+    }
+
+    /**
+     * @return The fullmove number, the last field of a FEN, 1 if it is missing.
+     */
+    int fullmove_number(const std::string& fen) {
+        auto start = fen.find_last_of(' ');
+        auto field = (start == std::string::npos) ? std::string{} : fen.substr(start + 1);
+        if (field.empty() || field.find_first_not_of("0123456789") != std::string::npos || field.size() > 4) {
+            return 1;
+        }
+        return std::max(1, std::stoi(field));
+    }
+
+    PositionHistory to_history(const std::vector<uint64_t>& keys) {
+        PositionHistory history;
+        for (auto key : keys) {
+            history.push(key);
+        }
+        return history;
+    }
+}
+
+// *****************************************************
+// Public Methods
+// *****************************************************
+
+Server::Server(const SearchLimits& limits, size_t hash_mb, unsigned int worker_count)
+        : limits(limits), hash_mb(hash_mb) {
+    Color side_to_move;
+    start_position = PackedPosition::pack(Fen::parse(Fen::START_POSITION, side_to_move), side_to_move);
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd == -1 || wake_fd == -1) {
+        throw std::runtime_error(std::string("could not create the event loop: ") + std::strerror(errno));
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = wake_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event);
+
+    for (unsigned int i = 0; i < worker_count; ++i) {
+        workers.emplace_back(&Server::work, this);
+    }
+}
+
+Server::~Server() {
+    {
+        std::lock_guard lock(jobs_mutex);
+        stopping = true;
+    }
+    jobs_available.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    for (const auto& [fd, session] : sessions) {
+        ::close(fd);
+    }
+
+    if (listen_fd != -1) {
+        ::close(listen_fd);
+    }
+    if (!socket_path.empty()) {
+        unlink(socket_path.c_str());
+    }
+    if (wake_fd != -1) {
+        ::close(wake_fd);
+    }
+    if (epoll_fd != -1) {
+        ::close(epoll_fd);
+    }
+}
+
+/**
+ * Listens on a unix domain socket, an existing socket file is replaced.
+ * @return true if the socket could be created.
+ */
+bool Server::listen_unix(const std::string& path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Socket path too long: " << path << std::endl;
+        return false;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    unlink(path.c_str());
+    auto fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (!listen_on(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address), path)) {
+        return false;
+    }
+
+    socket_path = path;
+    return true;
+}
+
+/**
+ * Listens on a tcp port of the loopback interface, so only local clients can connect.
+ * @return true if the socket could be created.
+ */
+bool Server::listen_tcp(int port) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    auto fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd != -1) {
+        int reuse = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    }
+
+    return listen_on(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address), "port " + std::to_string(port));
+}
+
+/**
+ * Handles the clients until the flag is set.
+ * @param stop Set by a signal handler or another thread, it is checked at least twice a second.
+ */
+void Server::run(const std::atomic<bool>& stop) {
+    epoll_event events[MAX_EVENTS];
+
+    while (!stop) {
+        auto count = epoll_wait(epoll_fd, events, MAX_EVENTS, 500);
+        if (count == -1 && errno != EINTR) {
+            std::cerr << "epoll_wait failed: " << std::strerror(errno) << std::endl;
+            return;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            auto fd = events[i].data.fd;
+
+            if (fd == listen_fd) {
+                accept_clients();
+            } else if (fd == wake_fd) {
+                uint64_t value;
+                while (read(wake_fd, &value, sizeof(value)) > 0) {
+                }
+                handle_results();
+            } else if (sessions.contains(fd)) {
+                // both directions of the connection are closed, nothing can be written anymore
+                if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+                    close_client(fd);
+                    continue;
+                }
+                if (events[i].events & EPOLLIN) {
+                    read_client(fd);
+                }
+                if ((events[i].events & EPOLLOUT) && sessions.contains(fd)) {
+                    write_client(fd);
+                }
+            }
+        }
+    }
+}
+
+// *****************************************************
+// Private Methods
+// *****************************************************
+
+bool Server::listen_on(int fd, const sockaddr* address, size_t address_length, const std::string& name) {
+    if (fd == -1 || bind(fd, address, static_cast<socklen_t>(address_length)) == -1 || listen(fd, SOMAXCONN) == -1) {
+        std::cerr << "Could not listen on " << name << ": " << std::strerror(errno) << std::endl;
+        if (fd != -1) {
+            ::close(fd);
+        }
+        return false;
+    }
+
+    listen_fd = fd;
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = listen_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event);
+
+    return true;
+}
+
+void Server::accept_clients() {
+    while (true) {
+        auto fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd == -1) {
+            return;
+        }
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.fd = fd;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) == -1) {
+            ::close(fd);
+            continue;
+        }
+
+        auto& session = sessions[fd];
+        session = Session{};
+        session.id = next_session_id++;
+        session.position = start_position;
+        session.events = event.events;
+    }
+}
+
+/**
+ * Reads everything the client sent and handles the complete lines.
+ */
+void Server::read_client(int fd) {
+    char buffer[4096];
+
+    auto& session = sessions[fd];
+
+    while (true) {
+        auto length = read(fd, buffer, sizeof(buffer));
+
+        if (length == -1 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            close_client(fd);
+            return;
+        }
+        if (length == -1) {
+            break;
+        }
+
+        // the client sends nothing more, but it still gets the answers to its commands
+        if (length == 0) {
+            session.finished_sending = true;
+            break;
+        }
+
+        session.input.append(buffer, static_cast<size_t>(length));
+    }
+
+    size_t start = 0;
+
+    for (auto end = session.input.find('\n'); end != std::string::npos; end = session.input.find('\n', start)) {
+        auto line = session.input.substr(start, end - start);
+        start = end + 1;
+
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+
+        // a broken command must not stop the games of all other clients
+        try {
+            handle_line(fd, session, line);
+        } catch (const std::exception& e) {
+            send(session, std::string("error ") + e.what());
+        }
+    }
+
+    session.input.erase(0, start);
+    if (session.input.size() > MAX_LINE) {
+        send(session, "error line too long");
+        session.closing = true;
+    }
+
+    write_client(fd);
+}
+
+/**
+ * Writes as much of the output as the socket takes, the rest is written when the socket is writable again.
+ */
+void Server::write_client(int fd) {
+    // the client may already be disconnected
+    auto it = sessions.find(fd);
+    if (it == sessions.end()) {
+        return;
+    }
+
+    auto& session = it->second;
+    size_t written = 0;
+
+    while (written < session.output.size()) {
+        auto length = ::send(fd, session.output.data() + written, session.output.size() - written, MSG_NOSIGNAL);
+        if (length == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (length == -1 && errno != EINTR) {
+            close_client(fd);
+            return;
+        }
+        if (length > 0) {
+            written += static_cast<size_t>(length);
+        }
+    }
+
+    session.output.erase(0, written);
+
+    auto done = session.closing || (session.finished_sending && !session.thinking);
+    if (session.output.size() > MAX_OUTPUT || (done && session.output.empty())) {
+        close_client(fd);
+        return;
+    }
+
+    // only wait for the socket to become writable while there is something to write,
+    // and stop reading from a client that sends nothing more, its socket would stay readable
+    uint32_t events = session.finished_sending ? 0 : EPOLLIN | EPOLLRDHUP;
+    if (!session.output.empty()) {
+        events |= EPOLLOUT;
+    }
+
+    if (events != session.events) {
+        epoll_event event{};
+        event.events = events;
+        event.data.fd = fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &event);
+        session.events = events;
+    }
+}
+
+/**
+ * Disconnects the client, a move the engine is still searching for it is dropped when it arrives.
+ */
+void Server::close_client(int fd) {
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    sessions.erase(fd);
+}
+
+/**
+ * Handles a command of the line protocol:
+ *   new [white|black] [fen]  starts a game, the client plays white by default
+ *   move <move>              plays a move in the standard algebraic or uci notation
+ *   fen                      prints the position
+ *   moves                    prints the legal moves in the uci notation
+ *   quit                     ends the connection
+ */
+void Server::handle_line(int fd, Session& session, const std::string& line) {
+    auto [command, arguments] = split_command(line);
+
+    if (command.empty() || session.closing) {
+        return;
+    }
+
+    if (command == "new") {
+        handle_new(fd, session, arguments);
+    } else if (command == "move") {
+        handle_move(fd, session, arguments);
+    } else if (command == "fen") {
+        Color side_to_move;
+        auto board = session.position.unpack(side_to_move);
+        send(session, "fen " + Fen::to_string(board, side_to_move, session.position.fullmove_number));
+    } else if (command == "moves") {
+        Color side_to_move;
+        auto board = session.position.unpack(side_to_move);
+        MoveList legal_moves;
+        MoveGen::generate_legal(board, side_to_move, legal_moves);
+
+        std::string text = "moves";
+        for (const auto& move : legal_moves) {
+            text += ' ';
+            text += Notation::to_uci(board, move).view();
+        }
+        send(session, text);
+    } else if (command == "quit") {
+        // a search that is still running is dropped
+        send(session, "bye");
+        session.closing = true;
+        session.generation++;
+    } else {
+        send(session, "error unknown command " + command);
+    }
+}
+
+void Server::handle_new(int fd, Session& session, const std::string& arguments) {
+    auto [color, fen] = split_command(arguments);
+    auto human = Color::WHITE;
+
+    if (color == "black") {
+        human = Color::BLACK;
+    } else if (color != "white") {
+        // there is no color, all arguments are the position
+        fen = arguments;
+    }
+
+    Color side_to_move;
+    PackedPosition position;
+
+    try {
+        auto board = Fen::parse(fen.empty() ? Fen::START_POSITION : fen, side_to_move);
+        position = PackedPosition::pack(board, side_to_move, fen.empty() ? 1 : fullmove_number(fen));
+    } catch (const std::invalid_argument& e) {
+        send(session, std::string("error ") + e.what());
+        return;
+    }
+
+    // a search of the previous game is dropped by the new generation
+    session.position = position;
+    session.keys.clear();
+    session.human = human;
+    session.generation++;
+    session.thinking = false;
+    session.over = false;
+
+    auto board = session.position.unpack(side_to_move);
+    send(session, "ok new " + Fen::to_string(board, side_to_move, session.position.fullmove_number));
+
+    // the position can already be checkmate or stalemate
+    check_game_over(session, board, side_to_move);
+
+    if (!session.over && side_to_move != human) {
+        start_engine(fd, session);
+    }
+}
+
+void Server::handle_move(int fd, Session& session, const std::string& text) {
+    if (session.over) {
+        send(session, "error no game");
+        return;
+    }
+
+    Color side_to_move;
+    auto board = session.position.unpack(side_to_move);
+
+    if (session.thinking || side_to_move != session.human) {
+        send(session, "error not your turn");
+        return;
+    }
+
+    MoveList legal_moves;
+    MoveGen::generate_legal(board, side_to_move, legal_moves);
+
+    auto move = Notation::from_uci(board, legal_moves, text);
+    if (!move.is_valid()) {
+        move = Notation::from_san(board, legal_moves, text);
+    }
+    if (!move.is_valid()) {
+        send(session, "error illegal move " + text);
+        return;
+    }
+
+    play_move(session, board, side_to_move, move, "ok move");
+
+    if (!session.over) {
+        start_engine(fd, session);
+    }
+}
+
+/**
+ * Plays the engine moves that were found since the last call.
+ */
+void Server::handle_results() {
+    std::vector<EngineResult> finished;
+    {
+        std::lock_guard lock(results_mutex);
+        finished.swap(results);
+    }
+
+    for (const auto& result : finished) {
+        auto it = sessions.find(result.fd);
+        if (it == sessions.end() || it->second.id != result.session_id || it->second.generation != result.generation) {
+            continue;
+        }
+
+        auto& session = it->second;
+        session.thinking = false;
+
+        Color side_to_move;
+        auto board = session.position.unpack(side_to_move);
+        auto move = unpack_move(board, result.move);
+
+        if (!move.is_valid()) {
+            send(session, "error the engine found no move");
+            session.over = true;
+        } else {
+            play_move(session, board, side_to_move, move, "engine");
+        }
+
+        write_client(result.fd);
+    }
+}
+
+/**
+ * Plays a legal move, sends it to the client and ends the game if it is over.
+ * @param board The gameboard of the session, it is changed by the move.
+ * @param prefix The start of the line that is sent.
+ */
+void Server::play_move(Session& session, GameBoard& board, Color side_to_move, const Move& move, const std::string& prefix) {
+    auto uci = Notation::to_uci(board, move);
+    auto san = Notation::to_san(board, side_to_move, move);
+
+    session.keys.push_back(Zobrist::hash(board, side_to_move));
+    board.make_move(move);
+    board.flip();
+
+    // no position before a capture or pawn move can repeat
+    if (board.get_halfmove_clock() == 0) {
+        session.keys.clear();
+    }
+
+    auto fullmove = session.position.fullmove_number + ((side_to_move == Color::BLACK) ? 1 : 0);
+    auto enemy = enemy_of(side_to_move);
+    session.position = PackedPosition::pack(board, enemy, fullmove);
+
+    send(session, prefix + " " + uci.str() + " " + san.str());
+    check_game_over(session, board, enemy);
+}
+
+/**
+ * Sends the result and ends the game if the player to move is checkmated or the game is drawn.
+ * @param board The gameboard of the session, seen from the player to move.
+ */
+void Server::check_game_over(Session& session, GameBoard& board, Color side_to_move) {
+    MoveList legal_moves;
+    MoveGen::generate_legal(board, side_to_move, legal_moves);
+
+    if (legal_moves.size() == 0 && board.is_king_in_check(side_to_move)) {
+        send(session, std::string("result ") + ((side_to_move == Color::BLACK) ? "1-0" : "0-1") + " checkmate");
+        session.over = true;
+    } else if (legal_moves.size() == 0) {
+        send(session, "result 1/2-1/2 stalemate");
+        session.over = true;
+    } else if (board.is_draw(to_history(session.keys), side_to_move)) {
+        send(session, "result 1/2-1/2 draw");
+        session.over = true;
+    }
+}
+
+void Server::start_engine(int fd, Session& session) {
+    session.thinking = true;
+    {
+        std::lock_guard lock(jobs_mutex);
+        jobs.push_back({fd, session.id, session.generation, session.position, session.keys});
+    }
+    jobs_available.notify_one();
+}
+
+void Server::send(Session& session, const std::string& line) {
+    session.output += line;
+    session.output += '\n';
+}
+
+/**
+ * Searches the jobs of the queue until the server stops.
+ */
+void Server::work() {
+    Search search{SearchOptions{}, hash_mb};
+
+    while (true) {
+        EngineJob job;
+        {
+            std::unique_lock lock(jobs_mutex);
+            jobs_available.wait(lock, [this]() { return stopping || !jobs.empty(); });
+            if (stopping) {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        Color side_to_move;
+        auto board = job.position.unpack(side_to_move);
+        auto result = search.think(board, side_to_move, limits, to_history(job.keys));
+
+        {
+            std::lock_guard lock(results_mutex);
+            results.push_back({job.fd, job.session_id, job.generation, pack_move(board, result.best_move)});
+        }
+
+        uint64_t one = 1;
+        [[maybe_unused]] auto written = write(wake_fd, &one, sizeof(one));
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include "search/Search.hpp"
+#include "storage/PackedPosition.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <sys/socket.h>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// one game of a client. the position is stored packed instead of as a gameboard,
+// so thousands of games fit into a few megabytes
+struct Session {
+    uint64_t id{0};
+    PackedPosition position;
+    std::vector<uint64_t> keys; // the zobrist hashes of the positions since the last capture or pawn move
+    Color human{Color::WHITE};
+    uint32_t generation{0};     // counts the games of the session, a late engine move of an old game is dropped
+    bool thinking{false};
+    bool over{true};
+    bool closing{false};          // the connection is closed as soon as the output is written
+    bool finished_sending{false}; // the connection is closed when the output is written and the engine has moved
+    uint32_t events{0};           // the events the event loop waits for
+    std::string input;
+    std::string output;
+};
+
+// a position the engine has to find a move for
+struct EngineJob {
+    int fd;
+    uint64_t session_id;
+    uint32_t generation;
+    PackedPosition position;
+    std::vector<uint64_t> keys;
+};
+
+struct EngineResult {
+    int fd;
+    uint64_t session_id;
+    uint32_t generation;
+    uint16_t move; // packed with pack_move, an invalid move if the engine found none
+};
+
+// hosts many games at once on a single thread with epoll, the clients talk a line protocol
+// over a unix domain socket or a tcp socket on the loopback interface.
+// the engine moves are searched by a pool of worker threads, every worker has its own search,
+// and the results are handed back to the event loop through an eventfd
+class Server {
+    SearchLimits limits;
+    size_t hash_mb;
+
+    int epoll_fd{-1};
+    int listen_fd{-1};
+    int wake_fd{-1};
+    std::string socket_path;
+
+    PackedPosition start_position;
+    std::unordered_map<int, Session> sessions;
+    uint64_t next_session_id{1};
+
+    std::vector<std::thread> workers;
+    std::mutex jobs_mutex;
+    std::condition_variable jobs_available;
+    std::deque<EngineJob> jobs;
+    bool stopping{false};
+
+    std::mutex results_mutex;
+    std::vector<EngineResult> results;
+
+    bool listen_on(int fd, const sockaddr* address, size_t address_length, const std::string& name);
+    void accept_clients();
+    void read_client(int fd);
+    void write_client(int fd);
+    void close_client(int fd);
+    void handle_line(int fd, Session& session, const std::string& line);
+    void handle_new(int fd, Session& session, const std::string& arguments);
+    void handle_move(int fd, Session& session, const std::string& text);
+    void handle_results();
+
+    void play_move(Session& session, GameBoard& board, Color side_to_move, const Move& move, const std::string& prefix);
+    static void check_game_over(Session& session, GameBoard& board, Color side_to_move);
+    void start_engine(int fd, Session& session);
+    static void send(Session& session, const std::string& line);
+
+    void work();
+
+public:
+    Server(const SearchLimits& limits, size_t hash_mb, unsigned int worker_count);
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+    ~Server();
+
+    bool listen_unix(const std::string& path);
+    bool listen_tcp(int port);
+    void run(const std::atomic<bool>& stop);
+};
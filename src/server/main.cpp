@@ -0,0 +1,100 @@
+#include "Server.hpp"
+#include "tablebase/Tablebases.hpp"
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// hosts many games against the engine at once, clients connect to a unix domain socket or a local tcp port
+// and play with a line protocol, see Server::handle_line
+
+namespace {
+    std::atomic<bool> stop{false};
+
+    void print_usage() {
+        std::cout << "Usage: server (--socket=path | --port=n) [--threads=n] [--depth=n] [--nodes=n] [--time=ms] [--hash=mb]" << std::endl;
+        std::cout << "Hosts games against the engine, the tcp port only accepts connections from this machine." << std::endl;
+        std::cout << "Commands: new [white|black] [fen], move <move>, fen, moves, quit." << std::endl;
+        std::cout << "Without limits every engine move is searched with 20000 nodes." << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string socket_path;
+    int port = 0;
+    auto threads = std::max(1u, std::thread::hardware_concurrency());
+    SearchLimits limits;
+    limits.depth = 0;
+    size_t hash_mb = 16;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string argument = argv[i];
+            auto value = argument.substr(argument.find('=') + 1);
+
+            if (argument.rfind("--socket=", 0) == 0) {
+                socket_path = value;
+            } else if (argument.rfind("--port=", 0) == 0) {
+                port = std::stoi(value);
+            } else if (argument.rfind("--threads=", 0) == 0) {
+                threads = static_cast<unsigned int>(std::max(1, std::stoi(value)));
+            } else if (argument.rfind("--depth=", 0) == 0) {
+                limits.depth = std::stoi(value);
+            } else if (argument.rfind("--nodes=", 0) == 0) {
+                limits.nodes = std::stoull(value);
+            } else if (argument.rfind("--time=", 0) == 0) {
+                limits.time_ms = std::stoll(value);
+            } else if (argument.rfind("--hash=", 0) == 0) {
+                hash_mb = std::stoul(value);
+            } else {
+                print_usage();
+                return argument == "--help" ? 0 : 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    if (socket_path.empty() == (port == 0)) {
+        print_usage();
+        return 1;
+    }
+
+    // many games at once, so every move is searched quickly
+    if (limits.depth <= 0) {
+        if (limits.nodes == 0 && limits.time_ms == 0) {
+            limits.nodes = 20000;
+        }
+        limits.depth = MAX_PLY - 1;
+    }
+
+    // the directories of the syzygy tablebase files, separated by ':'
+    if (auto syzygy_path = std::getenv("SYZYGY_PATH")) {
+        Tablebases::init(syzygy_path);
+    }
+
+    try {
+        Server server{limits, hash_mb, threads};
+
+        auto listening = socket_path.empty() ? server.listen_tcp(port) : server.listen_unix(socket_path);
+        if (!listening) {
+            return 1;
+        }
+
+        std::signal(SIGINT, [](int) { stop = true; });
+        std::signal(SIGTERM, [](int) { stop = true; });
+
+        std::cerr << "Listening on " << (socket_path.empty() ? "port " + std::to_string(port) : socket_path)
+                  << " with " << threads << " engine threads" << std::endl;
+        server.run(stop);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
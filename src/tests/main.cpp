@@ -0,0 +1,185 @@
+#include "fen/Fen.hpp"
+#include "gameboard/GameBoard.hpp"
+#include "hash/Zobrist.hpp"
+#include "movegen/MoveGen.hpp"
+#include "notation/Notation.hpp"
+#include "position/PositionHistory.hpp"
+#include "storage/PackedPosition.hpp"
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// quick checks of the engine that ctest runs after every build: perft counts of known positions,
+// fen strings that have to come out of the parser and a packed position unchanged and the draw rules of the gameboard.
+// the long random games and deeper perft numbers stay with movecheck
+
+namespace {
+    // a position with the number of leaf nodes for the depths 1, 2, ...
+    struct PerftReference {
+        const char* name;
+        const char* fen;
+        std::vector<uint64_t> nodes;
+    };
+
+    const std::vector<PerftReference> PERFT_REFERENCES = {
+        {"start", Fen::START_POSITION, {20, 400, 8902}},
+        {"kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", {48, 2039}},
+        {"endgame", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", {14, 191, 2812}},
+        {"promotions", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", {6, 264}},
+        {"discovered checks", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", {44, 1486}},
+        {"chess960", "bqnb1rkr/pp3ppp/3ppn2/2p5/5P2/P2P4/NPP1P1PP/BQ1BNRKR w HFhf - 2 9", {21, 528}},
+    };
+
+    const std::vector<const char*> ROUND_TRIP_FENS = {
+        Fen::START_POSITION,
+        "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "4k3/8/8/8/8/8/8/4K2R b K - 37 61",
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w HAha - 0 1",
+        "bqnb1rkr/pp3ppp/3ppn2/2p5/5P2/P2P4/NPP1P1PP/BQ1BNRKR w HFhf - 2 9",
+        "2r1k2r/8/8/8/8/8/8/R3K2R b Ah - 4 20",
+        "4k3/8/8/8/8/8/8/RR2K2R w HB - 0 30",
+    };
+
+    // a position and whether it is a draw without any history
+    struct DrawReference {
+        const char* name;
+        const char* fen;
+        bool draw;
+    };
+
+    const std::vector<DrawReference> DRAW_REFERENCES = {
+        {"king against king", "8/8/4k3/8/8/3K4/8/8 w - - 0 1", true},
+        {"king and knight against king", "8/8/4k3/8/8/3KN3/8/8 w - - 0 1", true},
+        {"king and bishop against king", "8/8/4k3/8/8/3KB3/8/8 b - - 0 1", true},
+        {"bishops on fields of the same color", "8/8/4kb2/8/8/3KB3/8/8 w - - 0 1", true},
+        {"bishops on fields of different colors", "8/8/4k1b1/8/8/3KB3/8/8 w - - 0 1", false},
+        {"two knights", "8/8/4k3/8/8/3KNN2/8/8 w - - 0 1", false},
+        {"king and rook against king", "8/8/4k3/8/8/R2K4/8/8 w - - 0 1", false},
+        {"king and pawn against king", "8/8/4k3/8/8/3KP3/8/8 w - - 0 1", false},
+        {"halfmove clock at 99", "8/8/4k3/8/8/R2K4/8/8 w - - 99 80", false},
+        {"halfmove clock at 100", "8/8/4k3/8/8/R2K4/8/8 w - - 100 80", true},
+    };
+
+    uint64_t perft(GameBoard& board, Color side_to_move, int depth) {
+        MoveList moves;
+        MoveGen::generate_legal(board, side_to_move, moves);
+
+        if (depth <= 1) {
+            return static_cast<uint64_t>(moves.size());
+        }
+
+        uint64_t nodes = 0;
+        for (const auto& move : moves) {
+            auto child = GameBoard{board};
+            child.make_move(move);
+            child.flip();
+            nodes += perft(child, enemy_of(side_to_move), depth - 1);
+        }
+
+        return nodes;
+    }
+
+    /**
+     * Prints a failed check.
+     * @return 1, to be added to the failures.
+     */
+    int fail(std::string_view name, std::string_view message) {
+        std::cout << name << ": " << message << " FAILED" << std::endl;
+        return 1;
+    }
+
+    int check_perft() {
+        auto failures = 0;
+
+        for (const auto& reference : PERFT_REFERENCES) {
+            Color side_to_move;
+            auto board = Fen::parse(reference.fen, side_to_move);
+
+            for (size_t depth = 1; depth <= reference.nodes.size(); ++depth) {
+                auto nodes = perft(board, side_to_move, static_cast<int>(depth));
+                if (nodes != reference.nodes[depth - 1]) {
+                    failures += fail(reference.name, "depth " + std::to_string(depth) + " counts " + std::to_string(nodes) +
+                                                     " nodes instead of " + std::to_string(reference.nodes[depth - 1]));
+                }
+            }
+        }
+
+        return failures;
+    }
+
+    int check_fen_round_trips() {
+        auto failures = 0;
+
+        for (std::string_view fen : ROUND_TRIP_FENS) {
+            Color side_to_move;
+            auto board = Fen::parse(fen, side_to_move);
+            auto fullmove_number = std::stoi(std::string(fen.substr(fen.rfind(' ') + 1)));
+
+            auto text = Fen::to_string(board, side_to_move, fullmove_number);
+            if (text != fen) {
+                failures += fail(fen, "is written as " + text);
+            }
+
+            auto unpacked = PackedPosition::pack(board, side_to_move, fullmove_number).unpack(side_to_move);
+            text = Fen::to_string(unpacked, side_to_move, fullmove_number);
+            if (text != fen) {
+                failures += fail(fen, "is unpacked as " + text);
+            }
+        }
+
+        return failures;
+    }
+
+    int check_draws() {
+        auto failures = 0;
+        PositionHistory history;
+
+        for (const auto& reference : DRAW_REFERENCES) {
+            Color side_to_move;
+            auto board = Fen::parse(reference.fen, side_to_move);
+            if (board.is_draw(history, side_to_move) != reference.draw) {
+                failures += fail(reference.name, reference.draw ? "is no draw" : "is a draw");
+            }
+        }
+
+        // the knights go out and back twice, the start position is on the board for the third time
+        // only after the last move
+        const std::vector<std::string_view> moves = {"g1f3", "g8f6", "f3g1", "f6g8", "g1f3", "g8f6", "f3g1", "f6g8"};
+        Color side_to_move;
+        auto board = Fen::parse(Fen::START_POSITION, side_to_move);
+
+        for (size_t i = 0; i < moves.size(); ++i) {
+            if (board.is_draw(history, side_to_move)) {
+                failures += fail("repetition", "draw after " + std::to_string(i) + " moves");
+            }
+
+            history.push(Zobrist::hash(board, side_to_move));
+            board.make_move(Notation::from_uci(board, side_to_move, moves[i]));
+            side_to_move = enemy_of(side_to_move);
+            board.flip();
+        }
+
+        if (!board.is_draw(history, side_to_move)) {
+            failures += fail("repetition", "no draw after the third repetition");
+        }
+
+        return failures;
+    }
+}
+
+int main() {
+    auto failures = check_perft() + check_fen_round_trips() + check_draws();
+
+    if (failures > 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}
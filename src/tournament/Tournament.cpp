@@ -0,0 +1,198 @@
+#include "Tournament.hpp"
+#include "hash/Zobrist.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <thread>
+
+namespace {
+    /**
+     * Converts a score between 0 and 1 into an elo difference.
+     */
+    double to_elo(double score) {
+        score = std::clamp(score, 1e-6, 1 - 1e-6);
+        return 400.0 * std::log10(score / (1.0 - score));
+    }
+}
+
+// *****************************************************
+// Public Methods
+// *****************************************************
+
+/**
+ * @return The average points per game of the first engine, a draw counts as half a point.
+ */
+double TournamentResult::score() const {
+    return games() ? (wins + 0.5 * draws) / games() : 0.5;
+}
+
+double TournamentResult::elo() const {
+    return to_elo(score());
+}
+
+/**
+ * @return Half the width of the 95% confidence interval of the elo difference.
+ */
+double TournamentResult::elo_error() const {
+    if (games() == 0) {
+        return 0;
+    }
+
+    auto n = static_cast<double>(games());
+    auto mean = score();
+    auto variance = (wins * std::pow(1.0 - mean, 2) + draws * std::pow(0.5 - mean, 2) + losses * std::pow(mean, 2)) / n;
+    auto deviation = 1.96 * std::sqrt(variance / n);
+
+    return (to_elo(mean + deviation) - to_elo(mean - deviation)) / 2;
+}
+
+/**
+ * Plays the games, every thread plays one game at a time.
+ * Game 2n and 2n + 1 start from the same opening with swapped colors.
+ * @param games The number of games.
+ * @param concurrency The number of games played at the same time.
+ * @param progress The result of every finished game is written to this stream.
+ * @return The results of all games.
+ */
+TournamentResult Tournament::run(int games, unsigned int concurrency, std::ostream& progress) {
+    result = {};
+    std::atomic<int> next_game{0};
+    auto start = std::chrono::steady_clock::now();
+
+    auto worker = [&]() {
+        // every thread has its own searches, they are not thread safe
+        Search first_search{first.options, first.hash_mb};
+        Search second_search{second.options, second.hash_mb};
+        std::vector<uint16_t> moves;
+
+        for (auto game = next_game++; game < games; game = next_game++) {
+            const auto& opening = openings[static_cast<size_t>(game / 2) % openings.size()];
+            auto first_is_white = (game % 2 == 0) == (opening.side_to_move == Color::WHITE);
+
+            first_search.clear();
+            second_search.clear();
+
+            moves.clear();
+            auto winner = play_game(opening, first_is_white, first_search, second_search, moves);
+            add_result(game, opening, first_is_white, winner, moves, progress);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < concurrency; ++i) {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    games_file.close();
+    return result;
+}
+
+/**
+ * Writes the games of the next run to a binary file of games.
+ * @param path The path of the file.
+ * @return true if the file could be created.
+ */
+bool Tournament::save_games(const std::string& path) {
+    return games_file.open(path, BinaryKind::GAMES);
+}
+
+/**
+ * Writes the summary of the tournament.
+ */
+void Tournament::report(const TournamentResult& result, const std::string& first_name, const std::string& second_name, std::ostream& out) {
+    out << std::fixed << std::setprecision(1);
+    out << first_name << " vs " << second_name << ": " << result.games() << " games" << std::endl;
+    out << "W/D/L: " << result.wins << "/" << result.draws << "/" << result.losses
+        << " (score " << std::setprecision(3) << result.score() << ")" << std::endl;
+    out << std::setprecision(1) << "Elo difference: " << result.elo() << " +/- " << result.elo_error() << std::endl;
+    out << std::setprecision(2) << "Games per second: " << (result.seconds > 0 ? result.games() / result.seconds : 0)
+        << " (" << result.seconds << " s)" << std::endl;
+}
+
+// *****************************************************
+// Private Methods
+// *****************************************************
+
+/**
+ * Plays one game, the moves of the engines are checked with the gameboard like in the console game.
+ * @param opening The start position.
+ * @param first_is_white If the first engine plays white.
+ * @param moves The moves of the game are appended, packed with pack_move.
+ * @return The color of the winner, DRAW for a draw.
+ */
+Color Tournament::play_game(const Opening& opening, bool first_is_white, Search& first_search, Search& second_search,
+                            std::vector<uint16_t>& moves) const {
+    auto board = GameBoard{opening.board};
+    auto current_player = opening.side_to_move;
+    PositionHistory history;
+
+    for (int ply = 0; ply < max_plies; ++ply) {
+        auto first_to_move = (current_player == Color::WHITE) == first_is_white;
+        const auto& engine = first_to_move ? first : second;
+        auto& search = first_to_move ? first_search : second_search;
+
+        auto move = search.think(board, current_player, engine.limits, history).best_move;
+
+        // an engine without a legal move forfeits, this only happens in positions that are already over
+        auto valid_moves = move.is_valid() ? board.get_valid_moves_for(move.get_from()) : VecPos{};
+        if (!move.get_to().exists_in(valid_moves)) {
+            return board.is_king_in_check(current_player) ? enemy_of(current_player) : Color::DRAW;
+        }
+
+        history.push(Zobrist::hash(board, current_player));
+        moves.push_back(pack_move(board, move));
+        board.make_move(move);
+
+        if (board.is_game_over(current_player)) {
+            return current_player;
+        }
+
+        // only the player to move can be stalemated
+        if (board.is_stalemate(current_player)) {
+            return Color::DRAW;
+        }
+
+        current_player = enemy_of(current_player);
+        board.flip();
+
+        if (board.is_draw(history, current_player)) {
+            return Color::DRAW;
+        }
+    }
+
+    // adjudicated as a draw, the game is too long
+    return Color::DRAW;
+}
+
+void Tournament::add_result(int game, const Opening& opening, bool first_is_white, Color winner, const std::vector<uint16_t>& moves,
+                            std::ostream& progress) {
+    std::lock_guard lock(result_mutex);
+
+    if (games_file.is_open()) {
+        auto start = PackedPosition::pack(opening.board, opening.side_to_move);
+        start.result = static_cast<int8_t>((winner == Color::WHITE) ? 1 : (winner == Color::BLACK) ? -1 : 0);
+        games_file.write_game(start, moves);
+    }
+
+    auto first_color = first_is_white ? Color::WHITE : Color::BLACK;
+    if (winner == Color::DRAW) {
+        ++result.draws;
+    } else if (winner == first_color) {
+        ++result.wins;
+    } else {
+        ++result.losses;
+    }
+
+    auto outcome = (winner == Color::DRAW) ? "1/2-1/2" : (winner == Color::WHITE) ? "1-0" : "0-1";
+    auto white = first_is_white ? first.name : second.name;
+    auto black = first_is_white ? second.name : first.name;
+
+    progress << "game " << game + 1 << " (" << opening.name << "): " << white << " - " << black << " " << outcome
+             << "  [" << result.wins << "/" << result.draws << "/" << result.losses << "]" << std::endl;
+}
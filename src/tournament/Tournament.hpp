@@ -0,0 +1,68 @@
+#pragma once
+#include "gameboard/GameBoard.hpp"
+#include "color/Color.hpp"
+#include "search/Search.hpp"
+#include "storage/BinaryFile.hpp"
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// the settings of one player of the tournament
+struct EngineConfig {
+    std::string name;
+    SearchOptions options;
+    SearchLimits limits;
+    size_t hash_mb{16};
+};
+
+// the start position of a pair of games, both engines play it once with each color
+struct Opening {
+    std::string name;
+    GameBoard board;
+    Color side_to_move;
+};
+
+// wins, draws and losses from the view of the first engine
+struct TournamentResult {
+    int wins{0};
+    int draws{0};
+    int losses{0};
+    double seconds{0};
+
+    [[nodiscard]] int games() const {
+        return wins + draws + losses;
+    }
+
+    [[nodiscard]] double score() const;
+    [[nodiscard]] double elo() const;
+    [[nodiscard]] double elo_error() const;
+};
+
+// plays games between two engine configurations on several threads at the same time,
+// with the same rules as the console game
+class Tournament {
+    EngineConfig first;
+    EngineConfig second;
+    std::vector<Opening> openings;
+    int max_plies;
+
+    std::mutex result_mutex;
+    TournamentResult result;
+    BinaryWriter games_file;
+
+    Color play_game(const Opening& opening, bool first_is_white, Search& first_search, Search& second_search,
+                    std::vector<uint16_t>& moves) const;
+    void add_result(int game, const Opening& opening, bool first_is_white, Color winner, const std::vector<uint16_t>& moves,
+                    std::ostream& progress);
+
+public:
+    Tournament(EngineConfig first, EngineConfig second, std::vector<Opening> openings, int max_plies)
+            : first(std::move(first)), second(std::move(second)), openings(std::move(openings)), max_plies(max_plies) {}
+
+    TournamentResult run(int games, unsigned int concurrency, std::ostream& progress);
+    bool save_games(const std::string& path);
+
+    static void report(const TournamentResult& result, const std::string& first_name, const std::string& second_name, std::ostream& out);
+};
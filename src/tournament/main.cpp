@@ -0,0 +1,260 @@
+#include "Tournament.hpp"
+#include "book/OpeningBook.hpp"
+#include "fen/Fen.hpp"
+#include "random/Random.hpp"
+#include "tablebase/Tablebases.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+// plays engine configurations against each other to measure the strength of a change
+
+namespace {
+    /**
+     * Reads an engine configuration like "nolmr,depth=6,lmr=off".
+     * The first part is the name, the others are the limits of a search and the search features.
+     * @throws std::invalid_argument if an option is unknown.
+     */
+    EngineConfig parse_engine(const std::string& text) {
+        EngineConfig engine;
+        engine.limits.depth = 0;
+
+        size_t start = 0;
+        for (int part = 0; start <= text.size(); ++part) {
+            auto end = text.find(',', start);
+            end = (end == std::string::npos) ? text.size() : end;
+            auto option = text.substr(start, end - start);
+            start = end + 1;
+
+            if (part == 0) {
+                engine.name = option;
+                continue;
+            }
+
+            auto separator = option.find('=');
+            auto key = option.substr(0, separator);
+            auto value = (separator == std::string::npos) ? std::string{} : option.substr(separator + 1);
+            auto enabled = value != "off" && value != "0";
+
+            if (key == "depth") {
+                engine.limits.depth = std::stoi(value);
+            } else if (key == "nodes") {
+                engine.limits.nodes = std::stoull(value);
+            } else if (key == "time") {
+                engine.limits.time_ms = std::stoll(value);
+            } else if (key == "hash") {
+                engine.hash_mb = std::stoul(value);
+            } else if (key == "null_move") {
+                engine.options.null_move = enabled;
+            } else if (key == "lmr") {
+                engine.options.late_move_reductions = enabled;
+            } else if (key == "rfp") {
+                engine.options.reverse_futility = enabled;
+            } else if (key == "futility") {
+                engine.options.futility = enabled;
+            } else if (key == "check_extensions") {
+                engine.options.check_extensions = enabled;
+            } else if (key == "tablebases") {
+                engine.options.tablebases = enabled;
+            } else {
+                throw std::invalid_argument("unknown engine option " + key);
+            }
+        }
+
+        // without any limit the games would take forever
+        if (engine.limits.depth <= 0) {
+            auto unlimited = engine.limits.nodes == 0 && engine.limits.time_ms == 0;
+            engine.limits.depth = unlimited ? 4 : MAX_PLY - 1;
+        }
+
+        return engine;
+    }
+
+    /**
+     * Reads the start positions from a file with one FEN or EPD position per line.
+     */
+    std::vector<Opening> read_openings(const std::string& path) {
+        std::ifstream file(path);
+        if (!file) {
+            throw std::invalid_argument("could not open " + path);
+        }
+
+        std::vector<Opening> openings;
+        std::string line;
+
+        for (size_t line_number = 1; std::getline(file, line); ++line_number) {
+            if (line.find_first_not_of(" \t\r") == std::string::npos || line[0] == '#') {
+                continue;
+            }
+
+            Color side_to_move;
+            auto board = Fen::parse(line, side_to_move);
+            auto id = std::string(Fen::epd_operation(line, "id"));
+            openings.push_back({id.empty() ? "line " + std::to_string(line_number) : id, board, side_to_move});
+        }
+
+        return openings;
+    }
+
+    /**
+     * Creates start positions by playing random moves of the opening book from the start position.
+     * @param count The number of positions.
+     * @param max_plies The number of half moves played from the book.
+     * @param random The generator choosing between the book moves.
+     */
+    std::vector<Opening> book_openings(const std::string& path, size_t count, size_t max_plies, Random& random) {
+        OpeningBook book;
+        if (!book.open(path)) {
+            throw std::invalid_argument("could not open " + path);
+        }
+
+        std::vector<Opening> openings;
+
+        for (size_t i = 0; i < count; ++i) {
+            GameBoard board{GameTest::NORMAL};
+            auto side_to_move = Color::WHITE;
+
+            for (size_t ply = 0; ply < max_plies; ++ply) {
+                auto move = book.probe(board, side_to_move, random);
+                if (!move.is_valid()) {
+                    break;
+                }
+
+                board.make_move(move);
+                board.flip();
+                side_to_move = enemy_of(side_to_move);
+            }
+
+            openings.push_back({"book " + std::to_string(i + 1), board, side_to_move});
+        }
+
+        return openings;
+    }
+
+    /**
+     * Picks random chess960 start positions, so the games do not need a book to differ.
+     * @param count The number of positions.
+     * @param random The generator choosing the positions.
+     */
+    std::vector<Opening> chess960_openings(size_t count, Random& random) {
+        std::vector<Opening> openings;
+
+        for (size_t i = 0; i < count; ++i) {
+            auto number = static_cast<int>(random.below(Fen::CHESS960_POSITIONS));
+            Color side_to_move;
+            auto board = Fen::parse(Fen::chess960(number), side_to_move);
+            openings.push_back({"chess960 " + std::to_string(number), board, side_to_move});
+        }
+
+        return openings;
+    }
+
+    void print_usage() {
+        std::cout << "Usage: tournament --first=engine --second=engine [--games=n] [--concurrency=n] [--max_plies=n]" << std::endl;
+        std::cout << "                  [--openings=file | --book=file [--book_depth=n] | --chess960] [--seed=n] [--save=file]" << std::endl;
+        std::cout << "An engine is a name followed by options, like base,depth=5 or nolmr,depth=5,lmr=off." << std::endl;
+        std::cout << "Options: depth, nodes, time (ms), hash (mb), null_move, lmr, rfp, futility, check_extensions, tablebases." << std::endl;
+        std::cout << "Every opening is played twice with swapped colors, the results are from the view of the first engine." << std::endl;
+        std::cout << "Without --openings or --book, or with --chess960, every pair of games starts from a random chess960 start position." << std::endl;
+        std::cout << "With --save the games are written to a binary file of games." << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string first_text = "first";
+    std::string second_text = "second";
+    int games = 20;
+    auto concurrency = std::max(1u, std::thread::hardware_concurrency());
+    int max_plies = 300;
+    std::string openings_path;
+    std::string book_path;
+    size_t book_depth = 8;
+    std::string save_path;
+    auto chess960 = false;
+    auto seed = static_cast<uint64_t>(time(nullptr));
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string argument = argv[i];
+            auto value = argument.substr(argument.find('=') + 1);
+
+            if (argument.rfind("--first=", 0) == 0) {
+                first_text = value;
+            } else if (argument.rfind("--second=", 0) == 0) {
+                second_text = value;
+            } else if (argument.rfind("--games=", 0) == 0) {
+                games = std::stoi(value);
+            } else if (argument.rfind("--concurrency=", 0) == 0) {
+                concurrency = static_cast<unsigned int>(std::max(1, std::stoi(value)));
+            } else if (argument.rfind("--max_plies=", 0) == 0) {
+                max_plies = std::stoi(value);
+            } else if (argument.rfind("--openings=", 0) == 0) {
+                openings_path = value;
+            } else if (argument.rfind("--book=", 0) == 0) {
+                book_path = value;
+            } else if (argument.rfind("--book_depth=", 0) == 0) {
+                book_depth = std::stoul(value);
+            } else if (argument == "--chess960") {
+                chess960 = true;
+            } else if (argument.rfind("--save=", 0) == 0) {
+                save_path = value;
+            } else if (argument.rfind("--seed=", 0) == 0) {
+                seed = std::stoull(value);
+            } else {
+                print_usage();
+                return argument == "--help" ? 0 : 1;
+            }
+        }
+
+        if (chess960 && (!openings_path.empty() || !book_path.empty())) {
+            print_usage();
+            return 1;
+        }
+
+        // the directories of the syzygy tablebase files, separated by ':'
+        if (auto syzygy_path = std::getenv("SYZYGY_PATH")) {
+            Tablebases::init(syzygy_path);
+        }
+
+        // the book chooses its moves randomly, like the chess960 positions.
+        // the seed is printed, so the same openings can be played again
+        Random random{seed};
+        std::cerr << "Seed " << seed << std::endl;
+
+        auto first = parse_engine(first_text);
+        auto second = parse_engine(second_text);
+
+        std::vector<Opening> openings;
+        if (!openings_path.empty()) {
+            openings = read_openings(openings_path);
+        } else if (!book_path.empty()) {
+            openings = book_openings(book_path, static_cast<size_t>(games + 1) / 2, book_depth, random);
+        } else {
+            // the engines are deterministic, from the same start position every pair of games would be the same.
+            // without an opening file or a book the games start from random chess960 positions
+            openings = chess960_openings(static_cast<size_t>(games + 1) / 2, random);
+        }
+
+        if (openings.empty()) {
+            throw std::invalid_argument("no openings in " + openings_path);
+        }
+
+        Tournament tournament{first, second, std::move(openings), max_plies};
+        if (!save_path.empty() && !tournament.save_games(save_path)) {
+            return 1;
+        }
+
+        auto result = tournament.run(games, concurrency, std::cerr);
+        Tournament::report(result, first.name, second.name, std::cout);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
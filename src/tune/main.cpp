@@ -0,0 +1,295 @@
+#include "eval/Evaluation.hpp"
+#include "storage/BinaryFile.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// tunes the parameters of the evaluation on positions labeled with the result of their game (see datagen),
+// by gradient descent on the error between the result and the evaluation mapped to a winning probability.
+//
+// the evaluation is linear in its parameters, so every position is loaded once as the list of its coefficients
+// and evaluated as the dot product with the dense vector of parameters
+
+namespace {
+    struct Options {
+        std::vector<std::string> inputs;
+        int epochs{200};
+        double rate{1.0};
+        double k{0};
+        double score_weight{0};
+        unsigned int threads{1};
+        std::string output;
+    };
+
+    // the positions of one thread, every thread computes the error and gradient of its own positions
+    struct Shard {
+        std::vector<EvalFeature> features;
+        std::vector<uint32_t> offsets{0}; // the features of position i are offsets[i] to offsets[i + 1]
+        std::vector<float> targets;       // the expected probability of a white win
+
+        [[nodiscard]] size_t size() const {
+            return targets.size();
+        }
+
+        [[nodiscard]] double evaluate(size_t position, const std::vector<double>& parameters) const {
+            double score = 0;
+            for (auto i = offsets[position]; i < offsets[position + 1]; ++i) {
+                score += parameters[features[i].index] * features[i].coefficient;
+            }
+            return score;
+        }
+    };
+
+    double sigmoid(double k, double score) {
+        return 1.0 / (1.0 + std::exp(-k * score));
+    }
+
+    /**
+     * Runs the function for every shard on its own thread.
+     */
+    template<typename Function>
+    void for_each_shard(std::vector<Shard>& shards, Function function) {
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < shards.size(); ++i) {
+            threads.emplace_back([&, i]() { function(i, shards[i]); });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    /**
+     * Loads the positions of the files, distributed over the shards.
+     * The target of a position is the result of its game, blended with the score of the search.
+     * @return false if a file could not be read.
+     */
+    bool load(const Options& options, std::vector<Shard>& shards) {
+        std::vector<BinaryReader> files(options.inputs.size());
+        for (size_t i = 0; i < files.size(); ++i) {
+            if (!files[i].open(options.inputs[i])) {
+                return false;
+            }
+        }
+
+        for_each_shard(shards, [&](size_t index, Shard& shard) {
+            size_t position_number = 0;
+
+            for (const auto& file : files) {
+                for (const auto& position : file.positions()) {
+                    if (position_number++ % shards.size() != index) {
+                        continue;
+                    }
+
+                    Color side_to_move;
+                    auto board = position.unpack(side_to_move);
+                    Evaluation::get_features(board, shard.features);
+                    shard.offsets.push_back(static_cast<uint32_t>(shard.features.size()));
+
+                    auto result = (position.result + 1) / 2.0;
+                    auto search = sigmoid(std::log(10.0) / 400.0, position.score);
+                    shard.targets.push_back(static_cast<float>(options.score_weight * search + (1 - options.score_weight) * result));
+                }
+            }
+        });
+
+        return true;
+    }
+
+    /**
+     * @return The mean squared error of the predicted results.
+     */
+    double error(std::vector<Shard>& shards, const std::vector<double>& parameters, double k) {
+        std::vector<double> errors(shards.size());
+        size_t count = 0;
+
+        for_each_shard(shards, [&](size_t index, const Shard& shard) {
+            for (size_t position = 0; position < shard.size(); ++position) {
+                auto difference = shard.targets[position] - sigmoid(k, shard.evaluate(position, parameters));
+                errors[index] += difference * difference;
+            }
+        });
+
+        double sum = 0;
+        for (size_t i = 0; i < shards.size(); ++i) {
+            sum += errors[i];
+            count += shards[i].size();
+        }
+        return count ? sum / static_cast<double>(count) : 0;
+    }
+
+    /**
+     * Finds the scaling of the scores that fits the current parameters best, so the tuning does not change
+     * the scale of the evaluation. The error is convex in k, a ternary search finds its minimum.
+     */
+    double fit_k(std::vector<Shard>& shards, const std::vector<double>& parameters) {
+        double low = 0.0001;
+        double high = 0.05;
+
+        for (int i = 0; i < 40; ++i) {
+            auto left = low + (high - low) / 3;
+            auto right = high - (high - low) / 3;
+
+            if (error(shards, parameters, left) < error(shards, parameters, right)) {
+                high = right;
+            } else {
+                low = left;
+            }
+        }
+
+        return (low + high) / 2;
+    }
+
+    /**
+     * Computes the gradient of the error, every thread sums the gradient of its positions separately.
+     */
+    void gradient(std::vector<Shard>& shards, const std::vector<double>& parameters, double k, std::vector<double>& result) {
+        std::vector<std::vector<double>> gradients(shards.size(), std::vector<double>(parameters.size()));
+        size_t count = 0;
+
+        for_each_shard(shards, [&](size_t index, const Shard& shard) {
+            auto& sum = gradients[index];
+
+            for (size_t position = 0; position < shard.size(); ++position) {
+                auto predicted = sigmoid(k, shard.evaluate(position, parameters));
+                auto factor = (predicted - shard.targets[position]) * predicted * (1 - predicted);
+
+                for (auto i = shard.offsets[position]; i < shard.offsets[position + 1]; ++i) {
+                    sum[shard.features[i].index] += factor * shard.features[i].coefficient;
+                }
+            }
+        });
+
+        for (const auto& shard : shards) {
+            count += shard.size();
+        }
+
+        std::fill(result.begin(), result.end(), 0.0);
+        for (const auto& sum : gradients) {
+            for (size_t i = 0; i < result.size(); ++i) {
+                result[i] += 2 * k * sum[i] / static_cast<double>(count);
+            }
+        }
+    }
+
+    void print_usage() {
+        std::cout << "Usage: tune files [--epochs=n] [--rate=x] [--k=x] [--score_weight=x] [--threads=n] [--output=file]" << std::endl;
+        std::cout << "Tunes the evaluation on binary files of positions, like the ones of datagen." << std::endl;
+        std::cout << "The target of a position is the result of its game, blended with the score of the search by --score_weight." << std::endl;
+        std::cout << "Without --k the scaling of the scores is fitted to the current evaluation." << std::endl;
+        std::cout << "The tuned tables are written as C++ source to the output file, or to standard output." << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string argument = argv[i];
+            auto value = argument.substr(argument.find('=') + 1);
+
+            if (argument.rfind("--epochs=", 0) == 0) {
+                options.epochs = std::stoi(value);
+            } else if (argument.rfind("--rate=", 0) == 0) {
+                options.rate = std::stod(value);
+            } else if (argument.rfind("--k=", 0) == 0) {
+                options.k = std::stod(value);
+            } else if (argument.rfind("--score_weight=", 0) == 0) {
+                options.score_weight = std::clamp(std::stod(value), 0.0, 1.0);
+            } else if (argument.rfind("--threads=", 0) == 0) {
+                options.threads = static_cast<unsigned int>(std::max(1, std::stoi(value)));
+            } else if (argument.rfind("--output=", 0) == 0) {
+                options.output = value;
+            } else if (argument.rfind("--", 0) != 0) {
+                options.inputs.push_back(argument);
+            } else {
+                print_usage();
+                return argument == "--help" ? 0 : 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    if (options.inputs.empty()) {
+        print_usage();
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Shard> shards(options.threads);
+
+    try {
+        if (!load(options, shards)) {
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    size_t count = 0;
+    for (const auto& shard : shards) {
+        count += shard.size();
+    }
+
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << "positions: " << count << ", loaded in " << seconds << " s" << std::endl;
+    if (count == 0) {
+        return 1;
+    }
+
+    auto parameters = Evaluation::get_parameters();
+    auto k = (options.k > 0) ? options.k : fit_k(shards, parameters);
+    std::cerr << "k: " << k << ", error: " << error(shards, parameters, k) << std::endl;
+
+    // adam, the step of every parameter adapts to the size of its gradients
+    constexpr double BETA1 = 0.9;
+    constexpr double BETA2 = 0.999;
+    constexpr double EPSILON = 1e-8;
+
+    std::vector<double> gradients(parameters.size());
+    std::vector<double> momentum(parameters.size());
+    std::vector<double> velocity(parameters.size());
+
+    for (int epoch = 1; epoch <= options.epochs; ++epoch) {
+        gradient(shards, parameters, k, gradients);
+
+        for (size_t i = 0; i < parameters.size(); ++i) {
+            momentum[i] = BETA1 * momentum[i] + (1 - BETA1) * gradients[i];
+            velocity[i] = BETA2 * velocity[i] + (1 - BETA2) * gradients[i] * gradients[i];
+
+            auto corrected_momentum = momentum[i] / (1 - std::pow(BETA1, epoch));
+            auto corrected_velocity = velocity[i] / (1 - std::pow(BETA2, epoch));
+            parameters[i] -= options.rate * corrected_momentum / (std::sqrt(corrected_velocity) + EPSILON);
+        }
+
+        if (epoch % 10 == 0 || epoch == options.epochs) {
+            std::cerr << "epoch " << epoch << ", error: " << error(shards, parameters, k) << std::endl;
+        }
+    }
+
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << "time: " << seconds << " s" << std::endl;
+
+    if (options.output.empty()) {
+        Evaluation::write_parameters(parameters, std::cout);
+        return 0;
+    }
+
+    std::ofstream out(options.output);
+    if (!out) {
+        std::cerr << "Could not create " << options.output << std::endl;
+        return 1;
+    }
+    Evaluation::write_parameters(parameters, out);
+
+    return 0;
+}